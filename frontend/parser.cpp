@@ -248,6 +248,10 @@ void Parser::parse_smtlib2_file(const std::string filename) {
 	scan_to_next_symbol();
 
 	while (*bufptr) {
+		if (dl != nullptr && dl->expired()) {
+			interrupted = true;
+			break;
+		}
 		parse_lpar();
 		if (parse_command() == CT_EXIT) break;
 		parse_rpar();
@@ -1574,9 +1578,9 @@ dagc * Parser::mk_mul(const std::vector<dagc *> &params) {
 dagc * Parser::mk_div_int(dagc * l, dagc * r) {
 
 	if (r->isconst()) {
-		if (l->isconst()) {
-			// all constants
-			return mk_const(l->v / r->v);
+		if (l->isconst() && r->v != 0) {
+			// all constants, (div x 0) is left to the solver
+			return mk_const(euclid_div(l->v, r->v));
 		}
 		// debug: 2021.11.27, integer cannot do like this.
 		// else {
@@ -1632,9 +1636,9 @@ dagc * Parser::mk_div_real(const std::vector<dagc *> &params) {
 */
 dagc * Parser::mk_mod(dagc * l, dagc * r) {
 
-	if (r->isconst() && l->isconst()) {
-		// all constants
-		return mk_const(l->v % r->v);
+	if (r->isconst() && l->isconst() && r->v != 0) {
+		// all constants, (mod x 0) is left to the solver
+		return mk_const(euclid_mod(l->v, r->v));
 	}
 	else {
 		// make new MOD operator
@@ -9,6 +9,7 @@
 #define PARSER_HEADER
 
 #include "frontend/dag.hpp"
+#include "utils/deadline.hpp"
 
 #define NDEBUG
 
@@ -69,9 +70,11 @@ namespace ismt {
 	public:
 
 		DAG & dag;
+		// the budget ran out before the end of the file
+		bool interrupted = false;
 		
 		// Jia: store the DAG in target.
-		Parser(std::string filename, DAG & target) : dag(target) {
+		Parser(std::string filename, DAG & target, deadline* d = nullptr) : dag(target), dl(d) {
 
 			err_node = new dagc(NT_ERROR);
 
@@ -182,6 +185,7 @@ namespace ismt {
 		char			*bufptr;
 		unsigned int 	line_number;
 		SCAN_MODE 		scan_mode;
+		deadline*		dl = nullptr;
 
 		boost::unordered_map<std::string, dagc *> key_map;
 		std::vector<std::string> vlet_key_list;
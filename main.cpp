@@ -12,7 +12,12 @@
 
 using namespace ismt;
 
-void sigalarm_handler(int){std::cout<<"unknown"<<std::endl; exit(0);}
+// the solver gives up with unknown at its next check, a second interrupt kills it.
+static qfnia_solver* running = nullptr;
+void sigalarm_handler(int sig){
+    if(running != nullptr) running->interrupt();
+    signal(sig, SIG_DFL);
+}
 int main(int argc, char* argv[]){
     if(argc >= 1){
         SolverOptions* StaticOptions = new SolverOptions();
@@ -34,7 +39,9 @@ int main(int argc, char* argv[]){
 
 
         qfnia_solver solver;
+        running = &solver;
         solver.solve(StaticOptions);
+        running = nullptr;
 
         delete StaticOptions;
     }
@@ -80,21 +80,33 @@ bool preprocessor::simplify(){
         // 0. convert to nnf-like tree.
         std::cout<<"\nnnf rewriting..."<<std::endl;
     #endif
-    nnfer->rewrite();
+    {
+        phase_timer timer(st, "nnf_rewriter");
+        nnfer->rewrite();
+    }
+    if(timeout()) return true;
 
     #if preDebug
         data->print_constraints();
         // 1. eliminate top(/true) let
         std::cout<<"\nlet operator rewriting..."<<std::endl;
     #endif
-    if(!check(leter->rewrite())) return false;
+    {
+        phase_timer timer(st, "let_rewriter");
+        if(!check(leter->rewrite())) return false;
+    }
+    if(timeout()) return true;
 
     #if preDebug
         data->print_constraints();
         // 2. eliminate logic operators.
         std::cout<<"\nlogic operation rewriting..."<<std::endl;
     #endif
-    logicer->rewrite();
+    {
+        phase_timer timer(st, "logic_rewriter");
+        logicer->rewrite();
+    }
+    if(timeout()) return true;
     #if preDebug
         data->print_constraints();
         // 3. comp rewriting.
@@ -102,7 +114,11 @@ bool preprocessor::simplify(){
         //  2) add x := y to model in equivalence rewriter.
         std::cout<<"\ncomparision equal rewriting..."<<std::endl;
     #endif
-    if(!check(eqer->rewrite())) return false;
+    {
+        phase_timer timer(st, "eq_rewriter");
+        if(!check(eqer->rewrite())) return false;
+    }
+    if(timeout()) return true;
     
     // data->print_smtlib();
     #if preDebug
@@ -110,7 +126,11 @@ bool preprocessor::simplify(){
         //  3) comp rewriting,
         std::cout<<"\ncomparision comp rewriting..."<<std::endl;
     #endif
-    if(!check(comper->rewrite())) return false;
+    {
+        phase_timer timer(st, "comp_rewriter");
+        if(!check(comper->rewrite())) return false;
+    }
+    if(timeout()) return true;
     // data->print_constraints();
     // model->print_partial();
     // data->print_smtlib();
@@ -120,7 +140,11 @@ bool preprocessor::simplify(){
         // 4. model propagation rewriting.
         std::cout<<"\npropagation rewriting..."<<std::endl;
     #endif
-    if(!check(proper->rewrite())) return false;
+    {
+        phase_timer timer(st, "prop_rewriter");
+        if(!check(proper->rewrite())) return false;
+    }
+    if(timeout()) return true;
 
     // model->print_partial();
     // data->print_smtlib();
@@ -156,9 +180,16 @@ bool preprocessor::simplify(){
     #endif
 
     // new appended 05/28
-    nnfer->rewrite();
+    {
+        phase_timer timer(st, "nnf_rewriter");
+        nnfer->rewrite();
+    }
     // 5. collector
-    if(!check(thector->rewrite())) return false;
+    {
+        phase_timer timer(st, "collector");
+        if(!check(thector->rewrite())) return false;
+    }
+    if(timeout()) return true;
     // new appended 06/02
     // x in [0, 1) -> x = 0
     #if preDebug
@@ -167,7 +198,11 @@ bool preprocessor::simplify(){
     #endif
 
     // model->print_partial();
-    if(!check(proper->rewrite())) return false;
+    {
+        phase_timer timer(st, "prop_rewriter");
+        if(!check(proper->rewrite())) return false;
+    }
+    if(timeout()) return true;
     // model->print_partial();
     
     // thector->print_feasible_set();
@@ -188,12 +223,21 @@ bool preprocessor::simplify(){
 
     // eq solver
     // now only use rewrite
-    if(!check(eqsver->solve())) return false;
+    if(timeout()) return true;
+    {
+        phase_timer timer(st, "eq_solver");
+        if(!check(eqsver->solve())) return false;
+    }
 
     return true;
 }
 
 
+bool preprocessor::timeout(){
+    if(dl != nullptr && dl->expired()) interrupted = true;
+    return interrupted;
+}
+
 Message* preprocessor::release(){
     // unsat
     if(message->state==State::UNSAT) return nullptr;
@@ -10,6 +10,7 @@
 
 #include "frontend/dag.hpp"
 #include "frontend/parser.hpp"
+#include "utils/statistics.hpp"
 #include "utils/disjoint_set.hpp"
 #include "utils/feasible_set.hpp"
 
@@ -57,6 +58,12 @@ namespace ismt
         Message* message;
         bool simplified = false; // whether simplified.
         model_s* model = nullptr;
+        // budget of the run, simplify stops between rewriters once it runs out.
+        deadline* dl = nullptr;
+        bool interrupted = false;
+        // -stats, null without it
+        statistics* st = nullptr;
+        bool timeout();
 
         void auto_set_model ();
         bool check(bool er);
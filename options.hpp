@@ -20,8 +20,11 @@ namespace ismt
     struct SolverOptions{
         std::string File = "";
         int Time = 1200;
+        int Memory = 0;
+        int Conflicts = 0;
         // std::string Combined_Solver_Name = "none";
         bool GA = true;
+        bool CSA = true;
         bool MA = true;
         bool VO = true;
         int Alpha = 1536;
@@ -31,16 +34,48 @@ namespace ismt
         bool DG = true;
         bool CM = true;
         int MaxBW = 128;
+        bool IW = false;
+        bool CG = false;
+        int P = 1;
+        int WR = 1;
+        int CC = 1;
+        bool SH = true;
+        bool Stats = false;
+        // comparator encodings of the blaster (0 slack, 1 recursion,
+        // 2 transposition), -1 for auto: each atom gets the cheapest one
+        // of the cost model, the rest the defaults of the blaster
+        int EqMode = -1;
+        int CompMode = -1;
+        // multiplier of the blaster (0 array, 1 wallace, 2 dadda, 3 auto)
+        int Mul = 0;
 
+        static int parseMode(const std::string& m, int mode){
+            if(m == "auto") return -1;
+            else if(m == "slack") return 0;
+            else if(m == "recursion") return 1;
+            else if(m == "transposition") return 2;
+            return mode;
+        }
         bool parse(int argc, char* argv[]){
             for(int i=1;i<argc;i++){
                 if(argv[i][0]=='-'){
                     std::string param = std::string(argv[i]);
                     if(param.size() > 3){
-                        if(param[1]=='T' && param[2]==':'){
+                        if(param == "-stats"){
+                            Stats = true;
+                        }
+                        else if(param[1]=='T' && param[2]==':'){
                             // time
                             Time = std::atoi(param.substr(3).c_str());
                         }
+                        else if(param[1]=='M' && param[2]==':'){
+                            // memory (MB)
+                            Memory = std::atoi(param.substr(3).c_str());
+                        }
+                        else if(param[1]=='C' && param[2]=='L' && param[3]==':'){
+                            // conflicts of each sat call
+                            Conflicts = std::atoi(param.substr(4).c_str());
+                        }
                         // else if(param[1]=='C' && param[2]=='S' && param[3]=='N' && param[4]==':'){
                         //     Combined_Solver_Name = param.substr(5);
                         // }
@@ -48,6 +83,10 @@ namespace ismt
                             if(param.substr(4) == "true") GA = true;
                             else GA = false;
                         }
+                        else if(param[1]=='C' && param[2]=='S' && param[3]=='A' && param[4]==':'){
+                            if(param.substr(5) == "true") CSA = true;
+                            else if(param.substr(5) == "false") CSA = false;
+                        }
                         else if(param[1]=='M' && param[2]=='A' && param[3]==':'){
                             if(param.substr(4) == "true") MA = true;
                             else if(param.substr(4) == "false") MA = false;
@@ -79,6 +118,43 @@ namespace ismt
                         else if(param[1]=='M' && param[2]=='a' && param[3]=='x' && param[4]=='B' && param[5]=='W' && param[6]==':'){
                             MaxBW = std::atoi(param.substr(7).c_str());
                         }
+                        else if(param[1]=='I' && param[2]=='W' && param[3]==':'){
+                            if(param.substr(4) == "true") IW = true;
+                            else if(param.substr(4) == "false") IW = false;
+                        }
+                        else if(param[1]=='P' && param[2]==':'){
+                            P = std::atoi(param.substr(3).c_str());
+                            if(P < 1) P = 1;
+                        }
+                        else if(param[1]=='W' && param[2]=='R' && param[3]==':'){
+                            WR = std::atoi(param.substr(4).c_str());
+                            if(WR < 1) WR = 1;
+                        }
+                        else if(param[1]=='S' && param[2]=='H' && param[3]==':'){
+                            if(param.substr(4) == "true") SH = true;
+                            else if(param.substr(4) == "false") SH = false;
+                        }
+                        else if(param[1]=='C' && param[2]=='C' && param[3]==':'){
+                            CC = std::atoi(param.substr(4).c_str());
+                            if(CC < 1) CC = 1;
+                        }
+                        else if(param[1]=='M' && param[2]=='U' && param[3]=='L' && param[4]==':'){
+                            std::string m = param.substr(5);
+                            if(m == "array") Mul = 0;
+                            else if(m == "wallace") Mul = 1;
+                            else if(m == "dadda") Mul = 2;
+                            else if(m == "auto") Mul = 3;
+                        }
+                        else if(param[1]=='E' && param[2]=='Q' && param[3]==':'){
+                            EqMode = parseMode(param.substr(4), EqMode);
+                        }
+                        else if(param[1]=='C' && param[2]=='M' && param[3]=='P' && param[4]==':'){
+                            CompMode = parseMode(param.substr(5), CompMode);
+                        }
+                        else if(param[1]=='C' && param[2]=='G' && param[3]==':'){
+                            if(param.substr(4) == "true") CG = true;
+                            else if(param.substr(4) == "false") CG = false;
+                        }
                     }
                     else if(param[1]=='h'){
                         print_help();
@@ -90,6 +166,9 @@ namespace ismt
                     // if multiple file, the final file is valid.
                 }
             }
+            // core-guided widening reads the range guards of incremental widening,
+            // and so keeps its encoding between the rounds as well.
+            if(CG) IW = true;
             if(File=="") return false;
             else return true;
         }
@@ -98,8 +177,11 @@ namespace ismt
             std::cout<<"Params: {"<<std::endl;
             std::cout<<"\tfile: "<<File<<std::endl;
             std::cout<<"\tTime: "<<Time<<std::endl;
+            std::cout<<"\tMemory: "<<Memory<<std::endl;
+            std::cout<<"\tConflicts: "<<Conflicts<<std::endl;
             // std::cout<<"\tCombined Solver Name: "<<Combined_Solver_Name<<std::endl;
             std::cout<<"\tGA: "<<GA<<std::endl;
+            std::cout<<"\tCSA: "<<CSA<<std::endl;
             std::cout<<"\tMA: "<<MA<<std::endl;
             std::cout<<"\tVO: "<<VO<<std::endl;
             std::cout<<"\tAlpha: "<<Alpha<<std::endl;
@@ -109,12 +191,25 @@ namespace ismt
             std::cout<<"\tDG: "<<DG<<std::endl;
             std::cout<<"\tCM: "<<CM<<std::endl;
             std::cout<<"\tMaxBW: "<<MaxBW<<std::endl;
+            std::cout<<"\tIW: "<<IW<<std::endl;
+            std::cout<<"\tCG: "<<CG<<std::endl;
+            std::cout<<"\tP: "<<P<<std::endl;
+            std::cout<<"\tWR: "<<WR<<std::endl;
+            std::cout<<"\tCC: "<<CC<<std::endl;
+            std::cout<<"\tSH: "<<SH<<std::endl;
+            std::cout<<"\tStats: "<<Stats<<std::endl;
+            std::cout<<"\tMUL: "<<Mul<<std::endl;
+            std::cout<<"\tEQ: "<<EqMode<<std::endl;
+            std::cout<<"\tCMP: "<<CompMode<<std::endl;
             std::cout<<"}"<<std::endl;
         }
         void print_help(){
             std::cout<<"BLAN 1.smt2 (the smt-lib file to solve)"<<std::endl;
             std::cout<<"\t-T:1200 (time limit (s), default 1200)"<<std::endl;
+            std::cout<<"\t-M:0 (memory limit (MB), 0 for none, default 0)"<<std::endl;
+            std::cout<<"\t-CL:0 (Conflict Limit of each sat call, 0 for none, default 0)"<<std::endl;
             std::cout<<"\t-GA:true (Greedy Addtion, default true)"<<std::endl;
+            std::cout<<"\t-CSA:true (Carry-Save Addition, blast each n-ary sum as one adder tree, default true)"<<std::endl;
             std::cout<<"\t-MA:true (Multiplication Adaptation, default true)"<<std::endl;
             std::cout<<"\t-VO:true (Vote, default true)"<<std::endl;
             std::cout<<"\t-Alpha:1536 (Alpha of Multiplication Adaptation, default 1536)"<<std::endl;
@@ -124,6 +219,16 @@ namespace ismt
             std::cout<<"\t-DG:true (Distinct Graph, default true)"<<std::endl;
             std::cout<<"\t-CM:true (Coefficient Matching, default true)"<<std::endl;
             std::cout<<"\t-MaxBW:128 (Maximum Bit-Width, default 128)"<<std::endl;
+            std::cout<<"\t-IW:false (Incremental Widening, keep the SAT solver between widths, default false)"<<std::endl;
+            std::cout<<"\t-CG:false (Core-Guided widening, only widen variables in the unsat core, implies -IW, default false)"<<std::endl;
+            std::cout<<"\t-P:1 (Portfolio, number of threads with diverse configurations, default 1)"<<std::endl;
+            std::cout<<"\t-WR:1 (Width Race, number of threads solving at consecutive widths, overrides -P, default 1)"<<std::endl;
+            std::cout<<"\t-CC:1 (Cube-and-Conquer, number of threads solving cubes of each sat call, default 1)"<<std::endl;
+            std::cout<<"\t-SH:true (SHare short learnt clauses between the threads of -P and -WR, default true)"<<std::endl;
+            std::cout<<"\t-MUL:array (MULtiplier encoding: array, wallace, dadda, or auto for dadda on wide operands, default array)"<<std::endl;
+            std::cout<<"\t-EQ:auto (EQuality encoding: slack, recursion, transposition, or auto for the cheapest by a cost model per atom, default auto)"<<std::endl;
+            std::cout<<"\t-CMP:auto (CoMParison encoding: slack, recursion, transposition, or auto for the cheapest by a cost model per atom, default auto)"<<std::endl;
+            std::cout<<"\t-stats (print a JSON report of the phases, sat calls and blasting costs, default off)"<<std::endl;
         }
     };
 
@@ -251,14 +251,15 @@ Integer checker::checkMathTerms(dagc* dag){
         #if checkDebug
             std::cout<<"( abs( "<<parameters[0]<<" )"<<std::endl;
         #endif
-        return parameters[0]>0?parameters[0]:-parameters[1];
+        return parameters[0]>0?parameters[0]:-parameters[0];
     }
     else if(dag->ismod()){
         assert(parameters.size()==2);
         #if checkDebug
             std::cout<<"( "<<parameters[0]<<" % "<<parameters[1]<<" )"<<std::endl;
         #endif
-        return parameters[0]%parameters[1];
+        if(parameters[1]==0) return 0; // unspecified, not checked
+        return euclid_mod(parameters[0], parameters[1]);
     }
     else if(dag->isdivint()){
         // definition of the functions div and mod:
@@ -270,28 +271,8 @@ Integer checker::checkMathTerms(dagc* dag){
         #if checkDebug
             std::cout<<"( "<<parameters[0]<<" / "<<parameters[1]<<" )"<<std::endl;
         #endif
-        // debug: 2021.11.08, div
-        if(parameters[0] % parameters[1] == 0){
-            return parameters[0] / parameters[1];
-        }
-        else if(parameters[0]<0 && parameters[1]>0){
-            // -3 / 2 = -2 ... 1
-            // -2 / 3 = -1 ... 1
-            return parameters[0] / parameters[1] - 1;
-        }
-        else if(parameters[0]>0 && parameters[1]<0){
-            // 3 / -2 = -1 ... 1
-            // 2 / -3 =  0 ... 2
-            return parameters[0] / parameters[1];
-        }
-        else if(parameters[0]<0 && parameters[1]>0){
-            // -3 / -2 = 2 ... 1
-            // -2 / -3 = 1 ... 1
-            return parameters[0] / parameters[1] + 1;
-        }
-        else{
-            return parameters[0] / parameters[1];
-        }
+        if(parameters[1]==0) return 0; // unspecified, not checked
+        return euclid_div(parameters[0], parameters[1]);
     }
     else if(dag->isadd()){
         #if checkDebug
@@ -708,6 +708,7 @@ bool Collector::rewrite(){
         state = State::UNSAT;
         return false;
     }
+    if(dl != nullptr && dl->expired()) return true;
     // update feasible set for variables
     update_feasible_set();
     #if colDebug
@@ -720,6 +721,7 @@ bool Collector::rewrite(){
         std::cout<<"\nbound collecting..."<<std::endl;
     #endif
     collect();
+    if(dl != nullptr && dl->expired()) return true;
     
     #if colDebug
         // 2. simplify unconstrainted variables.
@@ -727,6 +729,7 @@ bool Collector::rewrite(){
         std::cout<<"\nremoving unconstrained variables..."<<std::endl;
     #endif
     removeVars();
+    if(dl != nullptr && dl->expired()) return true;
 
     ans &= set_model();
     if(!ans){
@@ -23,6 +23,8 @@ namespace ismt
     public:
 
         State state = State::UNKNOWN;
+        // budget of the run, rewrite stops between its phases once it runs out.
+        deadline* dl = nullptr;
 
         // graph objects
         Graph<std::string> mustNeqGraph;                // must node neq-graph
@@ -131,6 +131,11 @@ void Decider::init(Info* i){
         atom_pool[i]->set_origin();
     }
     resort();
+    // the watched variables are decided here, it is done once in init so that
+    // the deciders of a portfolio never write the shared dag.
+    for(size_t i=0;i<watch_pool.size();i++){
+        watch_pool[i]->var->var->unassign();
+    }
 
     // 2023-05-29
     if(info->options->MaxBW != (int)max_width){
@@ -171,6 +176,11 @@ void Decider::init(Info* i){
 
     // new solver
     icp = new icp_solver(info->prep->polyer);
+    // register the variables to the polyer now, not from a portfolio thread
+    for(size_t i=0;i<watch_pool.size();i++){
+        dagc* var = watch_pool[i]->var->var;
+        if(var->isvnum()) info->prep->polyer->get_var(var);
+    }
 }
 
 Interval Decider::mk_interval(unsigned i){
@@ -206,6 +216,7 @@ void Decider::assign_bit(int bit){
 
 void Decider::assign_full(dagc* xvar){
     int bit = get_bit(xvar);
+    info->boxed.insert(xvar);
 
     // default interval
     assign_bit(bit); // defualt
@@ -294,6 +305,10 @@ int Decider::get_bit(dagc* xvar){
     // int pbit = phase_bit.find(xvar)==phase_bit.end()?0:std::min(phase_bit[xvar] + rephase_factor, (int)max_width);
     // // std::cout<<abit<<" "<<cbit<<" "<<dbit<<" "<<pbit<<std::endl;
     int ret_bit = std::max({cbit, dbit});
+    // core-guided: keep the width of the former round
+    if(info->options->CG && phase_bit.find(xvar) != phase_bit.end()){
+        ret_bit = std::max(ret_bit, phase_bit[xvar]);
+    }
     if(ret_bit > (int)max_width){
         b_conflict = true;
         ret_bit = max_width;
@@ -376,6 +391,8 @@ bool Decider::assign(dagc* xvar){
             else itv = mk_interval(getLower(i), bit, true);
             default_widths.emplace_back(bit);
             assignment.emplace_back(itv);
+            info->boxed.insert(xvar);
+            if(ninf(i)) info->boxed_above.insert(xvar);
         }
         else if(isPoint(i)){
             // [c, c] -> [c, c]
@@ -406,6 +423,12 @@ bool Decider::assign(dagc* xvar){
 bool Decider::conflict() const {
     return b_conflict;
 }
+unsigned Decider::get_width() const {
+    return def_width;
+}
+unsigned Decider::get_max_width() const {
+    return max_width;
+}
 
 void Decider::count_mul(dagc* cur, int& val){
     if(cur->ismul()){
@@ -457,13 +480,24 @@ void Decider::increment(const unsigned& idx){
     default_widths[idx] *= 2;
 }
 void Decider::increment(){
+    // core-guided: only widen the boxes in the core.
+    bool widened = false;
+    if(info->options->CG){
+        for(size_t i=0;i<info->core_vars.size();i++){
+            dagc* x = info->core_vars[i];
+            if(assign_index.find(x) != assign_index.end()){
+                increment(assign_index[x]);
+                widened = true;
+            }
+        }
+    }
     resort();
     for(size_t i=0;i<atom_pool.size();i++){
         atom_pool[i]->reset();
     }
     icp->reset();
     info->reset();
-    def_width = std::min(max_width, def_width*2);
+    if(!widened) def_width = std::min(max_width, def_width*2);
 }
 
 void Decider::collect_vars(dagc* cur, boost::unordered_set<dagc*>& vars){
@@ -574,13 +608,7 @@ void Decider::resort(){
     while(it!=assign_index.end()){
         dagc* x = it->first;
         int bit = default_widths[it->second];
-
-        if(phase_bit.find(x) != phase_bit.end()){
-            phase_bit.insert(std::pair<dagc*, int>(x, bit));
-        }
-        else{
-            phase_bit[x] = bit;
-        }
+        phase_bit[x] = bit;
         ++it;
     }
     assign_index.clear();
@@ -589,7 +617,6 @@ void Decider::resort(){
     for(unsigned i=0;i<watch_pool.size();i++){
         current.emplace_back(watch_pool[i]);
         dagc* var = watch_pool[i]->var->var;
-        var->unassign();
         if(watch_map.find(var) != watch_map.end()){
             watch_map[var] = i;
         }
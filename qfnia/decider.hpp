@@ -139,6 +139,8 @@ namespace ismt
         void increment          (const unsigned& idx);
         bool conflict           () const;
         int get_bit             (dagc* xvar);
+        unsigned get_width      () const;
+        unsigned get_max_width  () const;
     };
     
 } // namespace ismt
@@ -13,7 +13,9 @@
 #include "qfnia/collector.hpp"
 // 2023-05-27
 #include "options.hpp"
+#include "utils/statistics.hpp"
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 namespace ismt
 {
@@ -25,7 +27,21 @@ namespace ismt
         preprocessor* prep = nullptr;
         // 2023-05-27
         SolverOptions* options = nullptr;
+        // budget of the run, shared by the threads
+        deadline* dl = nullptr;
+        // -stats, null without it
+        statistics* st = nullptr;
+        int worker = 0;
         boost::unordered_map<dagc*, Interval> assignment;
+        // variables whose interval is a guessed bit-width box, not a bound from the collector
+        boost::unordered_set<dagc*> boxed;
+        // boxed variables bounded only from above, their box grows downwards
+        boost::unordered_set<dagc*> boxed_above;
+        // boxed variables whose range guard is in the last unsat core
+        std::vector<dagc*> core_vars;
+        // constraints whose assumption is in the last unsat core
+        std::vector<dagc*> core;
+        bool core_valid = false;
         std::vector<dagc*> variables;
         std::vector<dagc*> constraints;
         std::vector<int> assumptions;
@@ -43,6 +59,8 @@ namespace ismt
         Info(Message* m, Collector* c, preprocessor* pr, SolverOptions* opt): message(m), collector(c), prep(pr), options(opt){}
         ~Info(){}
 
+        bool expired(){ return dl != nullptr && dl->expired(); }
+
         void print_constraints(){
             for(size_t i=0;i<constraints.size();i++){
                 std::cout<<assumptions[i] <<": ";
@@ -56,6 +74,11 @@ namespace ismt
             assumptions.clear();
             variables.clear();
             assignment.clear();
+            boxed.clear();
+            boxed_above.clear();
+            core_vars.clear();
+            core.clear();
+            core_valid = false;
         }
         // void add_variables(dagc* var){
         //     variables.emplace_back(var);
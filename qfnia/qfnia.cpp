@@ -7,11 +7,16 @@
 
 #include "qfnia/qfnia.hpp"
 #include "qfnia/checker.hpp"
+#include <thread>
+#include <mutex>
+#include <map>
+#include <algorithm>
+#include <sstream>
 using namespace ismt;
 
 #define doCheck 0
 
-qfnia_solver::qfnia_solver(){}
+qfnia_solver::qfnia_solver(): stop(false), winner(-1){}
 qfnia_solver::~qfnia_solver(){
     if(used){
         delete data;        data = nullptr;
@@ -21,6 +26,13 @@ qfnia_solver::~qfnia_solver(){
         delete resolver;    resolver = nullptr;
         delete searcher;    searcher = nullptr;
     }
+    for(size_t i=0;i<exchanges.size();i++){
+        delete exchanges[i]; exchanges[i] = nullptr;
+    }
+}
+
+void qfnia_solver::interrupt(){
+    budget.interrupt();
 }
 
 void qfnia_solver::init(Info* info){
@@ -34,25 +46,58 @@ void qfnia_solver::init(Info* info){
 
 // main function
 int qfnia_solver::solve(SolverOptions* option){
+    int ret = _solve(option);
+    // on every way out, also when the budget ran out
+    if(option->Stats){
+        if(searcher != nullptr) searcher->flush();
+        // the constraints are named by their smt-lib text, printAST only writes to cout.
+        DAG* dag = data;
+        auto describe = [dag](const void* key){
+            std::ostringstream text;
+            std::streambuf* old = std::cout.rdbuf(text.rdbuf());
+            dag->printAST((dagc*)key);
+            std::cout.rdbuf(old);
+            return text.str();
+        };
+        stats.print(std::cout, state==State::SAT?"sat":(state==State::UNSAT?"unsat":"unknown"), describe);
+    }
+    return ret;
+}
+int qfnia_solver::_solve(SolverOptions* option){
+    statistics* st = option->Stats?&stats:nullptr;
     std::string file = option->File;
     used = true;
     data = new DAG();
 
     benchmark = file;
     model_s* model = new model_s();
+    budget.set_time(option->Time);
+    budget.set_memory(option->Memory);
+    budget.conflicts = option->Conflicts;
 
     // parse the file
     // std::cout<<"new parser start"<<std::endl;
-    Parser parser(file, *data);
+    double wall = statistics::wall(), cpu = statistics::cpu();
+    Parser parser(file, *data, &budget);
+    if(st != nullptr) st->add_phase("parse", statistics::wall() - wall, statistics::cpu() - cpu);
     // std::cout<<"new parser end"<<std::endl;
     collector = new Collector(&parser, model);
+    collector->dl = &budget;
 
     // std::cout<<"new preprocessor start"<<std::endl;
     prep = new preprocessor(&parser, collector, model);
+    prep->dl = &budget;
+    prep->st = st;
     // std::cout<<"new preprocessor end"<<std::endl;
-    bool ans = prep->simplify();
+    bool ans = parser.interrupted?true:prep->simplify();
+    if(parser.interrupted || prep->interrupted){
+        state = State::UNKNOWN;
+        std::cout<<"unknown"<<std::endl;
+        return 0;
+    }
     if(ans){
         if(prep->state == State::SAT){
+            state = State::SAT;
             std::cout<<"sat"<<std::endl;
             if(data->get_model){
                 Message* message = prep->release();
@@ -62,6 +107,7 @@ int qfnia_solver::solve(SolverOptions* option){
         }
     }
     else{
+        state = State::UNSAT;
         std::cout<<"unsat"<<std::endl;
         return 0;
     }
@@ -71,13 +117,31 @@ int qfnia_solver::solve(SolverOptions* option){
     // message->print_constraints();
 
     // start to solve
+    if(option->WR > 1) return race(message, option);
+    if(option->P > 1) return portfolio(message, option);
+
     Info* info = new Info(message, collector, prep, option);
+    info->dl = &budget;
+    info->st = st;
     init(info);
     // model->print_partial();
 
-    // main loop
-    while(true){
-        while(decider->decide()){}
+    state = run(info, decider, searcher, resolver);
+    report(info, searcher, message);
+
+    return 0;
+}
+
+// main loop
+State qfnia_solver::run(Info* info, Decider* decider, Searcher* searcher, Resolver* resolver){
+    while(!stop){
+        {
+            phase_timer timer(info->st, "decide");
+            while(decider->decide()){
+                if(info->expired()) break;
+            }
+        }
+        if(info->expired()) break;
         if(decider->conflict()){
             // decide with bit blasting overflow
             // std::cout<<"unknown"<<std::endl;
@@ -86,12 +150,14 @@ int qfnia_solver::solve(SolverOptions* option){
             break;
         }
         if(!searcher->search()){
+            // cancelled by another thread or out of budget
+            if(stop || info->expired()) break;
+            phase_timer timer(info->st, "resolve");
             if(!resolver->resolve()){
-                state = State::UNSAT;
                 break;
             }
             else{
-                if(resolver->has_lemma()) message->constraints.insert(message->constraints.begin(), resolver->lemma()); // add lemma in the front
+                if(resolver->has_lemma()) info->message->constraints.insert(info->message->constraints.begin(), resolver->lemma()); // add lemma in the front
                 // must increment
                 decider->increment();
                 searcher->reset();
@@ -101,40 +167,10 @@ int qfnia_solver::solve(SolverOptions* option){
             if(decider->done()) break;
         }
     }
+    return info->state;
+}
 
-    // int bound = 100;
-    // int cnt = 0;
-    // while(true){
-    //     if(decider->decide()){
-    //         ++cnt;
-    //     }
-    //     if(decider->conflict()){
-    //         // decide with bit blasting overflow
-    //         std::cout<<"to do, conflict"<<std::endl;
-    //         // invoking yices2
-    //         exit(0);
-    //     }
-    //     if(cnt >= bound){
-    //         if(!searcher->search()){
-    //             if(!resolver->resolve()){
-    //                 state = State::UNSAT;
-    //                 break;
-    //             }
-    //             else{
-    //                 if(resolver->has_lemma()) message->constraints.insert(message->constraints.begin(), resolver->lemma()); // add lemma in the front
-    //                 // must increment
-    //                 decider->increment();
-    //                 searcher->reset();
-    //             }
-    //         }
-    //         else{
-    //             if(decider->done()) break;
-    //         }
-    //         cnt = 0;
-    //     }
-    // }
-
-
+void qfnia_solver::report(Info* info, Searcher* searcher, Message* message){
     if(info->state==State::SAT){
         searcher->set_model();
         std::cout<<"sat"<<std::endl;
@@ -155,6 +191,254 @@ int qfnia_solver::solve(SolverOptions* option){
     else{
         std::cout<<"unsat"<<std::endl;
     }
+}
+
+// the idx-th configuration of the portfolio, idx 0 keeps the given one.
+// the comparators are chosen per atom by the cost model, or all by
+// transposition.
+void qfnia_solver::diversify(SolverOptions& option, unsigned idx){
+    switch(idx % 8){
+        case 0: break;
+        case 1: option.MA = false; break;
+        case 2: option.VO = false; option.DG = false; break;
+        case 3: option.EqMode = 2; option.CompMode = 2; break;
+        case 4: option.GA = false; option.CM = false; break;
+        case 5: option.CG = true; option.IW = true; break;
+        case 6: option.Beta = option.Beta + 2; option.K = option.K * 2; break;
+        case 7: option.Beta = std::max(2, option.Beta - 2); option.Gamma = option.Gamma / 2; break;
+    }
+    // the next rounds of the table scale the multiplication adaptation
+    for(unsigned i=0;i<idx / 8;i++){
+        option.Alpha = option.Alpha * 2;
+    }
+}
+
+qfnia_worker* qfnia_solver::mk_worker(Message* message, const SolverOptions& option){
+    qfnia_worker* w = new qfnia_worker(option);
+    w->options.P = 1;
+    w->options.WR = 1;
+    w->options.CC = 1;
+    w->info = new Info(message, collector, prep, &w->options);
+    w->info->dl = &budget;
+    w->info->st = option.Stats?&stats:nullptr;
+    w->decider = new Decider();
+    w->searcher = new Searcher();
+    w->resolver = new Resolver();
+    w->decider->init(w->info);
+    w->searcher->init(w->info);
+    w->resolver->init(w->info);
+    return w;
+}
+
+// the options of the decider, the workers with the same family blast the same
+// boxes round by round.
+std::string qfnia_solver::family(const SolverOptions& option){
+    std::string s;
+    s += std::to_string(option.MaxBW) + ",";
+    s += std::to_string(option.MA) + "," + std::to_string(option.VO) + ",";
+    s += std::to_string(option.DG) + "," + std::to_string(option.CM) + ",";
+    s += std::to_string(option.Alpha) + "," + std::to_string(option.Beta) + ",";
+    s += std::to_string(option.Gamma) + "," + std::to_string(option.K);
+    return s;
+}
+
+// a learnt clause over the bits of the variables and the constraints holds in
+// any exact encoding of the same or smaller boxes. div/mod are not exact, and
+// the reserved encoding of -IW is wider than its boxes.
+void qfnia_solver::share(Message* message, std::vector<qfnia_worker*>& workers){
+    if(workers.size() < 2 || !workers[0]->options.SH) return;
+    std::vector<dagc*> constraints(message->constraints.begin(), message->constraints.end());
+    if(!workers[0]->resolver->exact(constraints)) return;
+    std::map<std::string, std::vector<qfnia_worker*> > groups;
+    for(size_t i=0;i<workers.size();i++){
+        if(workers[i]->options.IW || workers[i]->options.CG) continue;
+        groups[family(workers[i]->options)].emplace_back(workers[i]);
+    }
+    for(auto it=groups.begin();it!=groups.end();++it){
+        if(it->second.size() < 2) continue;
+        sat_exchange* e = new sat_exchange();
+        exchanges.emplace_back(e);
+        for(size_t i=0;i<it->second.size();i++){
+            it->second[i]->searcher->setExchange(e, i);
+        }
+    }
+}
+
+int qfnia_solver::portfolio(Message* message, SolverOptions* option){
+    // the stacks are built here one by one, only the loops run in parallel.
+    std::vector<qfnia_worker*> workers;
+    for(int i=0;i<option->P;i++){
+        SolverOptions opt = *option;
+        diversify(opt, i);
+        qfnia_worker* w = mk_worker(message, opt);
+        w->info->worker = i;
+        w->searcher->setTerminator(&stop);
+        workers.emplace_back(w);
+    }
+    share(message, workers);
+
+    winner = -1;
+    std::vector<std::thread> threads;
+    for(size_t i=0;i<workers.size();i++){
+        threads.emplace_back([this, &workers, i](){
+            qfnia_worker* w = workers[i];
+            if(run(w->info, w->decider, w->searcher, w->resolver) != State::UNKNOWN){
+                // the first definitive answer cancels the others.
+                int expected = -1;
+                if(winner.compare_exchange_strong(expected, (int)i)) stop = true;
+            }
+        });
+    }
+    for(size_t i=0;i<threads.size();i++){
+        threads[i].join();
+    }
+
+    if(winner >= 0){
+        qfnia_worker* w = workers[winner];
+        state = w->info->state;
+        report(w->info, w->searcher, message);
+    }
+    else{
+        std::cout<<"unknown"<<std::endl;
+    }
+
+    for(size_t i=0;i<workers.size();i++){
+        workers[i]->searcher->flush();
+        delete workers[i]; workers[i] = nullptr;
+    }
+    return 0;
+}
+
+// width race results of a job
+#define RACE_UNKNOWN    0   // cancelled
+#define RACE_SAT        1
+#define RACE_UNSAT      2   // unsat at this width
+#define RACE_REFUTED    3   // unsat over all integers
+#define RACE_OVERFLOW   4   // beyond the maximum width
+
+// one round of the main loop at the given width level, i.e. the default
+// width doubled level times. the levels of a worker only go up.
+int qfnia_solver::race_job(qfnia_worker* w, int level){
+    while(w->level < level){
+        w->decider->increment();
+        w->searcher->reset();
+        ++w->level;
+    }
+    while(w->decider->decide()){
+        if(w->info->expired()) return RACE_UNKNOWN;
+    }
+    if(w->decider->conflict()) return RACE_OVERFLOW;
+    if(w->searcher->search()) return RACE_SAT;
+    if(w->cancel || w->info->expired()) return RACE_UNKNOWN;
+    // the conflicts of the call ran out
+    if(!w->info->core_valid) return RACE_UNKNOWN;
+    if(!w->resolver->resolve()){
+        return w->info->state == State::UNSAT ? RACE_REFUTED : RACE_OVERFLOW;
+    }
+    return RACE_UNSAT;
+}
+
+// the boxes only grow with the width, so a model at a width is a model at any
+// larger one, and an unsat width means all smaller widths are unsat.
+// the workers take the levels in order; an unsat level cancels the smaller ones
+// in flight, a sat level the larger ones. the answer is the lowest sat level
+// once all below it are unsat, the same with any timing of the threads.
+int qfnia_solver::race(Message* message, SolverOptions* option){
+    SolverOptions opt = *option;
+    // the levels are independent rounds, no solver is kept across widths.
+    opt.IW = false;
+    opt.CG = false;
+    std::vector<qfnia_worker*> workers;
+    for(int i=0;i<option->WR;i++){
+        qfnia_worker* w = mk_worker(message, opt);
+        w->info->worker = i;
+        w->searcher->setTerminator(&w->cancel);
+        workers.emplace_back(w);
+    }
+    share(message, workers);
+
+    // the levels up to the maximum width
+    unsigned width = workers[0]->decider->get_width();
+    unsigned max_width = workers[0]->decider->get_max_width();
+    int levels = 1;
+    while(levels < 32 && width < max_width){
+        width = width * 2;
+        ++levels;
+    }
+
+    std::mutex mtx;
+    int next = 0;
+    int sat_level = levels;
+    int sat_worker = -1;
+    bool refuted = false;
+    std::vector<std::thread> threads;
+    for(size_t i=0;i<workers.size();i++){
+        threads.emplace_back([&, i](){
+            qfnia_worker* w = workers[i];
+            while(true){
+                int level = 0;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if(refuted || next >= sat_level || next >= levels || budget.expired()) break;
+                    level = next++;
+                    w->job = level;
+                    w->cancel = false;
+                }
+                int res = race_job(w, level);
+                std::lock_guard<std::mutex> lock(mtx);
+                w->job = -1;
+                if(res == RACE_SAT){
+                    if(level < sat_level){
+                        sat_level = level;
+                        sat_worker = (int)i;
+                        for(size_t j=0;j<workers.size();j++){
+                            if(workers[j]->job > level) workers[j]->cancel = true;
+                        }
+                    }
+                    // keep the model
+                    break;
+                }
+                else if(res == RACE_UNSAT){
+                    for(size_t j=0;j<workers.size();j++){
+                        if(workers[j]->job >= 0 && workers[j]->job < level) workers[j]->cancel = true;
+                    }
+                }
+                else if(res == RACE_REFUTED){
+                    refuted = true;
+                    for(size_t j=0;j<workers.size();j++){
+                        workers[j]->cancel = true;
+                    }
+                }
+                else if(res == RACE_OVERFLOW){
+                    levels = std::min(levels, level);
+                    for(size_t j=0;j<workers.size();j++){
+                        if(workers[j]->job > level) workers[j]->cancel = true;
+                    }
+                }
+            }
+        });
+    }
+    for(size_t i=0;i<threads.size();i++){
+        threads[i].join();
+    }
+
+    if(refuted){
+        state = State::UNSAT;
+        std::cout<<"unsat"<<std::endl;
+    }
+    else if(sat_worker >= 0){
+        qfnia_worker* w = workers[sat_worker];
+        state = w->info->state;
+        report(w->info, w->searcher, message);
+    }
+    else{
+        state = State::UNKNOWN;
+        std::cout<<"unknown"<<std::endl;
+    }
 
+    for(size_t i=0;i<workers.size();i++){
+        workers[i]->searcher->flush();
+        delete workers[i]; workers[i] = nullptr;
+    }
     return 0;
-}
\ No newline at end of file
+}
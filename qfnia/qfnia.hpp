@@ -23,10 +23,34 @@
 // 2023-05-27
 #include "options.hpp"
 
+#include "utils/statistics.hpp"
+#include <atomic>
+
 namespace ismt
 {
     // static poly::Context context();
     const int maxVars = 256;
+
+    // a decide/search/resolve stack of the portfolio, with its own options.
+    struct qfnia_worker{
+        SolverOptions   options;
+        Info*           info = nullptr;
+        Decider*        decider = nullptr;
+        Searcher*       searcher = nullptr;
+        Resolver*       resolver = nullptr;
+        // width race: the job (width level) in hand and the level of the decider
+        std::atomic<bool> cancel;
+        int             job = -1;
+        int             level = 0;
+        qfnia_worker(const SolverOptions& opt): options(opt), cancel(false){}
+        ~qfnia_worker(){
+            delete decider;     decider = nullptr;
+            delete searcher;    searcher = nullptr;
+            delete resolver;    resolver = nullptr;
+            delete info;        info = nullptr;
+        }
+    };
+
     class qfnia_solver{
     private:
         DAG* data;
@@ -40,6 +64,25 @@ namespace ismt
         Decider* decider = nullptr;
         Resolver* resolver = nullptr;
         Searcher* searcher = nullptr;
+        // portfolio
+        std::atomic<bool> stop;
+        std::atomic<int> winner;
+        // budget of the run
+        deadline budget;
+        statistics stats;
+        int  _solve(SolverOptions* option);
+
+        State run(Info* info, Decider* d, Searcher* s, Resolver* r);
+        void report(Info* info, Searcher* s, Message* message);
+        void diversify(SolverOptions& option, unsigned idx);
+        int  portfolio(Message* message, SolverOptions* option);
+        qfnia_worker* mk_worker(Message* message, const SolverOptions& option);
+        // clause sharing between the workers that decide the same boxes
+        std::vector<sat_exchange*> exchanges;
+        std::string family(const SolverOptions& option);
+        void share(Message* message, std::vector<qfnia_worker*>& workers);
+        int  race_job(qfnia_worker* w, int level);
+        int  race(Message* message, SolverOptions* option);
     public:
         qfnia_solver();
         ~qfnia_solver();
@@ -48,6 +91,8 @@ namespace ismt
         void init(Info* info);
         // int solve(const std::string& file);
         int solve(SolverOptions* option);
+        // give up with unknown, async-signal-safe
+        void interrupt();
     };
 } // namespace ismt
 
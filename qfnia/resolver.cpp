@@ -47,6 +47,49 @@ bool Resolver::is_hard(std::vector<dagc*>& constraints){
     }
     return false;
 }
+// whether the constraint has a variable with a guessed box.
+bool Resolver::is_boxed(dagc* constraint, boost::unordered_set<dagc*>& visited){
+    if(visited.find(constraint) != visited.end()) return false;
+    visited.insert(constraint);
+    if(constraint->isvnum()){
+        return info->boxed.find(constraint) != info->boxed.end();
+    }
+    for(size_t i=0;i<constraint->children.size();i++){
+        if(is_boxed(constraint->children[i], visited)) return true;
+    }
+    return false;
+}
+// div/mod assert their side conditions as hard clauses, which are not exact
+// over the integers (e.g. the divisor is never 0).
+bool Resolver::is_inexact(dagc* constraint, boost::unordered_set<dagc*>& visited){
+    if(visited.find(constraint) != visited.end()) return false;
+    visited.insert(constraint);
+    if(constraint->isdiv()) return true;
+    for(size_t i=0;i<constraint->children.size();i++){
+        if(is_inexact(constraint->children[i], visited)) return true;
+    }
+    return false;
+}
+// the unsat core is width-independent if it has no range guard and none of
+// its constraints reads a boxed variable. the other variables are blasted with
+// their collected bounds, and the boxes only restrict the boxed variables,
+// so the core is unsat over all integers.
+bool Resolver::width_independent(){
+    if(!info->core_valid || info->core_vars.size() != 0) return false;
+    if(!exact(info->constraints)) return false;
+    boost::unordered_set<dagc*> visited;
+    for(size_t i=0;i<info->core.size();i++){
+        if(is_boxed(info->core[i], visited)) return false;
+    }
+    return true;
+}
+bool Resolver::exact(const std::vector<dagc*>& constraints){
+    boost::unordered_set<dagc*> visited;
+    for(size_t i=0;i<constraints.size();i++){
+        if(is_inexact(constraints[i], visited)) return false;
+    }
+    return true;
+}
 bool Resolver::has_lemma() const{
     return core.size() != 0;
 }
@@ -67,6 +110,10 @@ bool Resolver::resolve(){
     //     }
     // }
 
+    if(width_independent()){
+        info->state = State::UNSAT;
+        return false;
+    }
     return true;
 }
 // bool Resolver::cad_resolve(std::vector<dagc*>& constraints){
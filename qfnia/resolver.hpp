@@ -9,6 +9,7 @@
 #define _RESOLVER_H
 
 #include "qfnia/info.hpp"
+#include <boost/unordered_set.hpp>
 
 namespace ismt
 {
@@ -24,6 +25,9 @@ namespace ismt
         bool is_hard(std::vector<dagc*>& constraints);
         bool is_hard(dagc* constraint);
         bool cad_resolve(std::vector<dagc*>& constraints);
+        bool is_boxed(dagc* constraint, boost::unordered_set<dagc*>& visited);
+        bool is_inexact(dagc* constraint, boost::unordered_set<dagc*>& visited);
+        bool width_independent();
     public:
         Resolver(/* args */);
         ~Resolver();
@@ -33,6 +37,8 @@ namespace ismt
         bool resolve();
         dagc* lemma();
         bool has_lemma() const;
+        // no constraint has div/mod
+        bool exact(const std::vector<dagc*>& constraints);
     };
     
 } // namespace ismt
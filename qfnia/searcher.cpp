@@ -23,13 +23,37 @@ Searcher::~Searcher(){
 
 void Searcher::init(Info* i){
     info = i;
+    transformer->GA = info->options->GA;
+    transformer->CSA = info->options->CSA;
+    transformer->MaxReserve = info->options->MaxBW;
+    transformer->EqMode = info->options->EqMode;
+    transformer->CompMode = info->options->CompMode;
+    if(info->options->CC > 1) solver->setCubes(info->options->CC);
+    solver->setDeadline(info->dl);
+    solver->setCounting(info->st != nullptr);
+    if(info->options->EqMode >= 0){
+        solver->setvvEqMode((ConstraintsMode)info->options->EqMode);
+        solver->setviEqMode((ConstraintsMode)info->options->EqMode);
+    }
+    if(info->options->CompMode >= 0){
+        solver->setvvCompMode((ConstraintsMode)info->options->CompMode);
+        solver->setviCompMode((ConstraintsMode)info->options->CompMode);
+    }
+    solver->setMulMode((MultiplierMode)info->options->Mul);
     // declare the assigned variable
-    std::vector<dagc*> vars;
-    info->message->model->getAssignedVars(vars);
-    for(unsigned i=0;i<vars.size();i++){
-        _declare(vars[i]);
+    info->message->model->getAssignedVars(constants);
+    for(unsigned i=0;i<constants.size();i++){
+        _declare(constants[i]);
     }
-    transformer->GA = info->options->GA;
+}
+void Searcher::setTerminator(const std::atomic<bool>* flag){
+    solver->setTerminator(flag);
+}
+// the boxes only grow with the rounds, so a clause learnt in a round holds in
+// the earlier rounds of the searchers deciding the same way.
+void Searcher::setExchange(sat_exchange* e, int id){
+    solver->setExchange(e, id);
+    solver->setStamp(round);
 }
 
 void Searcher::_declare(dagc* root){
@@ -37,6 +61,15 @@ void Searcher::_declare(dagc* root){
         if(root->isAssigned()){
             transformer->_declare(root, root->v, false, root->v, false);
         }
+        else if(info->options->IW && info->boxed.find(root) != info->boxed.end()){
+            Interval i(info->assignment[root]);
+            transformer->_reserve(root, 
+                to_long(getLower(i)), 
+                poly::get_lower_open(i), 
+                to_long(getUpper(i)), 
+                poly::get_upper_open(i),
+                info->boxed_above.find(root) != info->boxed_above.end());
+        }
         else{
             Interval i(info->assignment[root]);
             transformer->_declare(root, 
@@ -51,8 +84,30 @@ void Searcher::_declare(dagc* root){
     }
 }
 int Searcher::_assert(dagc* root){
+    if(info->options->IW){
+        if(asserted.find(root) != asserted.end()) return asserted[root];
+        int lit = transformer->_assert(root);
+        asserted.insert(std::pair<dagc*, int>(root, lit));
+        return lit;
+    }
     return transformer->_assert(root);
 }
+// a reserved variable outgrew its reservation: blast the round from scratch.
+void Searcher::rebuild(){
+    solver->reset();
+    conflicts = decisions = propagations = 0;
+    transformer->reset();
+    asserted.clear();
+    for(unsigned i=0;i<constants.size();i++){
+        _declare(constants[i]);
+    }
+    for(unsigned i=0;i<info->variables.size();i++){
+        _declare(info->variables[i]);
+    }
+    for(unsigned i=0;i<info->constraints.size();i++){
+        info->assumptions[i] = _assert(info->constraints[i]);
+    }
+}
 bool Searcher::search(){
     // check whether it is needed to re-transform
     // if not modify the former constraints and not change the assignment
@@ -61,17 +116,26 @@ bool Searcher::search(){
     for(unsigned i=0;i<info->new_vars.size();i++){
         _declare(info->new_vars[i]);
     }
+    info->core.clear();
+    info->core_vars.clear();
+    info->core_valid = false;
     if(info->new_constraints.size() == 0) return true;
-    #if assertDebug
-        std::cout<<"----------------------searching----------------------"<<std::endl;
-    #endif
-    for(unsigned i=0;i<info->new_constraints.size();i++){
+    {
+        phase_timer timer(info->st, "blast");
+        if(transformer->outgrown()) rebuild();
         #if assertDebug
-            info->message->data->printAST(info->new_constraints[i]);
-            std::cout<<std::endl;
+            std::cout<<"----------------------searching----------------------"<<std::endl;
         #endif
-        info->constraints.emplace_back(info->new_constraints[i]);
-        info->assumptions.emplace_back(_assert(info->new_constraints[i]));
+        for(unsigned i=0;i<info->new_constraints.size();i++){
+            // blasting a large constraint may take long
+            if(info->expired()) return false;
+            #if assertDebug
+                info->message->data->printAST(info->new_constraints[i]);
+                std::cout<<std::endl;
+            #endif
+            info->constraints.emplace_back(info->new_constraints[i]);
+            info->assumptions.emplace_back(_assert(info->new_constraints[i]));
+        }
     }
     info->new_vars.clear();
     info->new_constraints.clear();
@@ -80,13 +144,55 @@ bool Searcher::search(){
     #endif
 
     // solve
-    bool ans = solver->solve(info->assumptions);
+    literals assumptions(info->assumptions);
+    transformer->guards(assumptions);
+    bool ans = false;
+    {
+        phase_timer timer(info->st, "sat");
+        ans = solver->solve(assumptions);
+    }
+    if(info->st != nullptr) record(ans);
     if(ans){
         info->state = State::SAT;
         return true;
     }
+    if(solver->unsat()){
+        literals core;
+        solver->getConflict(core);
+        boost::unordered_set<int> failed(core.begin(), core.end());
+        for(size_t i=0;i<info->constraints.size();i++){
+            if(failed.find(info->assumptions[i]) != failed.end()){
+                info->core.emplace_back(info->constraints[i]);
+            }
+        }
+        transformer->guarded(core, info->core_vars);
+        info->core_valid = true;
+    }
     return false;
 }
+void Searcher::record(bool ans){
+    statistics::round r;
+    r.worker = info->worker;
+    r.index = round;
+    r.vars = solver->nVars();
+    r.clauses = solver->nClauses();
+    int64_t c = solver->statistic("conflicts");
+    int64_t d = solver->statistic("decisions");
+    int64_t p = solver->statistic("propagations");
+    r.conflicts = c - conflicts;
+    r.decisions = d - decisions;
+    r.propagations = p - propagations;
+    conflicts = c; decisions = d; propagations = p;
+    r.result = ans?"sat":(solver->unsat()?"unsat":"unknown");
+    info->st->add_round(r);
+    flush();
+}
+// also on the way out, e.g. when the budget runs out while blasting.
+void Searcher::flush(){
+    if(info == nullptr || info->st == nullptr || solver == nullptr) return;
+    solver->flushCounts(info->st);
+    transformer->flushCosts(info->st);
+}
 void Searcher::set_model(){
     for(size_t i=0;i<info->variables.size();i++){
         dagc* var = info->variables[i];
@@ -94,13 +200,19 @@ void Searcher::set_model(){
     }
 }
 void Searcher::reset(){
+    ++round;
+    if(info->options->IW){
+        // keep the sat solver and its learnt clauses, only the guards change.
+        transformer->unguard();
+        return;
+    }
     solver->reset();
     transformer->reset();
+    solver->setStamp(round);
+    conflicts = decisions = propagations = 0;
     // declare the assigned variable
-    std::vector<dagc*> vars;
-    info->message->model->getAssignedVars(vars);
-    for(unsigned i=0;i<vars.size();i++){
-        _declare(vars[i]);
+    for(unsigned i=0;i<constants.size();i++){
+        _declare(constants[i]);
     }
 }
 
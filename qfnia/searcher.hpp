@@ -12,6 +12,7 @@
 
 #include "solvers/blaster/blaster_solver.hpp"
 #include "solvers/blaster/blaster_transformer.hpp"
+#include <boost/unordered_set.hpp>
 
 namespace ismt
 {
@@ -22,8 +23,18 @@ namespace ismt
      blaster_transformer* transformer = nullptr;
      blaster_solver* solver = nullptr;
      bool used = false;
+     // variables assigned by the preprocessor
+     std::vector<dagc*> constants;
+     // incremental widening: constraint -> literal, kept across rounds
+     boost::unordered_map<dagc*, int> asserted;
+     // rounds since init, the stamp of the shared clauses
+     int round = 0;
+     // -stats: counters of the sat solver at the last call, they restart with it
+     int64_t conflicts = 0, decisions = 0, propagations = 0;
+     void record(bool ans);
      void _declare(dagc* root);
      int  _assert(dagc* root);
+     void rebuild();
 
    public:
         Searcher(/* args */);
@@ -31,8 +42,11 @@ namespace ismt
 
         void init(Info* i);
         bool search();
+        void flush(); // -stats: the blast costs not reported by a sat call yet
         void reset();
         void set_model();
+        void setTerminator(const std::atomic<bool>* flag);
+        void setExchange(sat_exchange* e, int id);
    };
    
 } // namespace ismt
@@ -77,21 +77,17 @@ void prop_rewriter::evaluatePoly(dagc*& root){
                 root = parser->mk_const(0);
             }
         }
-        else if(root->isdiv()){
-            // y / x
+        else if(root->isdivint() || root->isdivreal()){
+            // y / x, isdiv would take mod as well
             evaluatePoly(root->children[0]);
             evaluatePoly(root->children[1]);
             dagc* y = root->children[0];
             dagc* x = root->children[1];
-            if(y->isAssigned() && x->isAssigned()){
-                if(y->v % x->v != 0){
-                    assert(false);
-                }
-                else{
-                    Integer res = y->v / x->v;
-                    root->assign(res);
-                    root = parser->mk_const(res);
-                }
+            // y / 0 is unspecified, left to the solver
+            if(y->isAssigned() && x->isAssigned() && x->v != 0){
+                Integer res = euclid_div(y->v, x->v);
+                root->assign(res);
+                root = parser->mk_const(res);
             }
         }
         else if(root->ismod()){
@@ -101,8 +97,8 @@ void prop_rewriter::evaluatePoly(dagc*& root){
             dagc* y = root->children[0];
             dagc* x = root->children[1];
             assert(x->iscnum());
-            if(y->isAssigned() && x->isAssigned()){
-                Integer res = y->v % x->v;
+            if(y->isAssigned() && x->isAssigned() && x->v != 0){
+                Integer res = euclid_mod(y->v, x->v);
                 root->assign(res);
                 root = parser->mk_const(res);
             }
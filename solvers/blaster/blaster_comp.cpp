@@ -13,7 +13,7 @@ using namespace ismt;
 // ------------math atom operations------------
 
 // math atom operations
-literal blaster_solver::Less(bvar var1, bvar var2){ // var1 < var2
+literal blaster_solver::Less(bvar var1, bvar var2, Polarity pol){ // var1 < var2
     if(var1==var2) return solver->False();
     if(var1->isConstant()&&var2->isConstant()){
         return var1->getCurValue() < var2->getCurValue()?solver->True():solver->False();
@@ -21,13 +21,13 @@ literal blaster_solver::Less(bvar var1, bvar var2){ // var1 < var2
     assert(!var1->isConstant() || !var2->isConstant());
 
     if(var1->isConstant() || var2->isConstant()){
-        return viGt(var2, var1);
+        return viGt(var2, var1, pol);
     }
     else{
-        return vvGt(var2, var1);
+        return vvGt(var2, var1, pol);
     }
 }
-literal blaster_solver::Equal(bvar var1, bvar var2){
+literal blaster_solver::Equal(bvar var1, bvar var2, Polarity pol){
     if(var1==var2) return solver->True();
     if(var1->isConstant()&&var2->isConstant()){
         return var1->getCurValue() == var2->getCurValue()?solver->True():solver->False();
@@ -35,13 +35,13 @@ literal blaster_solver::Equal(bvar var1, bvar var2){
     assert(!var1->isConstant() || !var2->isConstant());
     
     if(var1->isConstant() || var2->isConstant()){
-        return viEq(var1, var2);
+        return viEq(var1, var2, pol);
     }
     else{
-        return vvEq(var1, var2);
+        return vvEq(var1, var2, pol);
     }
 }
-literal blaster_solver::Greater(bvar var1, bvar var2){ // var1 > var2
+literal blaster_solver::Greater(bvar var1, bvar var2, Polarity pol){ // var1 > var2
     if(var1==var2) return solver->False();
     if(var1->isConstant()&&var2->isConstant()){
         return var1->getCurValue() > var2->getCurValue()?solver->True():solver->False();
@@ -49,13 +49,13 @@ literal blaster_solver::Greater(bvar var1, bvar var2){ // var1 > var2
     assert(!var1->isConstant() || !var2->isConstant());
 
     if(var1->isConstant() || var2->isConstant()){
-        return viGt(var1, var2);
+        return viGt(var1, var2, pol);
     }
     else{
-        return vvGt(var1, var2);
+        return vvGt(var1, var2, pol);
     }
 }
-literal blaster_solver::NotEqual(bvar var1, bvar var2){
+literal blaster_solver::NotEqual(bvar var1, bvar var2, Polarity pol){
     if(var1==var2) return solver->False();
     if(var1->isConstant()&&var2->isConstant()){
         return var1->getCurValue() != var2->getCurValue()?solver->True():solver->False();
@@ -63,13 +63,13 @@ literal blaster_solver::NotEqual(bvar var1, bvar var2){
     assert(!var1->isConstant() || !var2->isConstant());
 
     if(var1->isConstant() || var2->isConstant()){
-        return viNeq(var1, var2);
+        return viNeq(var1, var2, pol);
     }
     else{
-        return vvNeq(var1, var2);
+        return vvNeq(var1, var2, pol);
     }
 }
-literal blaster_solver::LessEqual(bvar var1, bvar var2){ // var1 <= var2
+literal blaster_solver::LessEqual(bvar var1, bvar var2, Polarity pol){ // var1 <= var2
     if(var1==var2) return solver->True();
     if(var1->isConstant()&&var2->isConstant()){
         return var1->getCurValue() <= var2->getCurValue()?solver->True():solver->False();
@@ -77,13 +77,13 @@ literal blaster_solver::LessEqual(bvar var1, bvar var2){ // var1 <= var2
     assert(!var1->isConstant() || !var2->isConstant());
 
     if(var1->isConstant() || var2->isConstant()){
-        return viGe(var2, var1);
+        return viGe(var2, var1, pol);
     }
     else{
         return vvGe(var2, var1);
     }
 }
-literal blaster_solver::GreaterEqual(bvar var1, bvar var2){
+literal blaster_solver::GreaterEqual(bvar var1, bvar var2, Polarity pol){
     if(var1==var2) return solver->True();
     if(var1->isConstant()&&var2->isConstant()){
         return var1->getCurValue() >= var2->getCurValue()?solver->True():solver->False();
@@ -91,10 +91,66 @@ literal blaster_solver::GreaterEqual(bvar var1, bvar var2){
     assert(!var1->isConstant() || !var2->isConstant());
     
     if(var1->isConstant() || var2->isConstant()){
-        return viGe(var1, var2);
+        return viGe(var1, var2, pol);
     }
     else{
         return vvGe(var1, var2);
     }
     
 }
+
+
+// ------------cost model------------
+
+// n bits per operand, a full adder is 2 vars and 14 clauses, a half adder
+// against a constant half of it.
+blaster_solver::atomCost blaster_solver::estimate(ConstraintsMode m, bool eq, bool strict, bvar var1, bvar var2) const{
+    atomCost c;
+    bool vi = var1->isConstant() || var2->isConstant();
+    bvar var = var1->isConstant()? var2: var1;
+    long n = vi? var->size(): max(var1->size(), var2->size());
+    bool zero = vi && (var1->isConstant()? var1: var2)->getCurValue() == 0;
+    // var >= 0 is the sign in every mode
+    if(m == Recursion && !(zero && !eq && !strict)){
+        if(eq){
+            // an xnor per bit under an and, against a constant the bits
+            c.vars = vi? 1: n + 1;
+            c.clauses = vi? n + 1: 5 * n + 1;
+            c.depth = vi? 1: 2;
+        }
+        else{
+            // a majority chain, and / or against a constant
+            c.vars = n;
+            c.clauses = vi? 3 * n: 6 * n;
+            c.depth = n;
+        }
+        return c;
+    }
+    if(!zero){
+        // the difference, or the slack and its sum
+        if(m == Slack || DiffMap.find(std::make_pair(var1, var2)) == DiffMap.end()){
+            c.vars = vi && m != Slack? n: 2 * n;
+            c.clauses = vi && m != Slack? 7 * n: 14 * n;
+        }
+        if(m == Slack){
+            c.vars += n;
+            c.clauses += vi? n: 2 * n;
+        }
+        c.depth = n;
+    }
+    // the zero test, free for the sign
+    if(eq || strict){
+        c.vars += 1;
+        c.clauses += n + 1;
+        c.depth += 1;
+    }
+    return c;
+}
+ConstraintsMode blaster_solver::cheapest(bool eq, bool strict, bvar var1, bvar var2) const{
+    ConstraintsMode best = Recursion;
+    long cost = estimate(Recursion, eq, strict, var1, var2).total();
+    long t = estimate(Transposition, eq, strict, var1, var2).total();
+    if(t < cost){ best = Transposition; cost = t; }
+    if(estimate(Slack, eq, strict, var1, var2).total() < cost) best = Slack;
+    return best;
+}
@@ -11,7 +11,6 @@ using namespace ismt;
 
 // ------------Equal operations------------
 void blaster_solver::innerEqualVar(bvar var1, bvar var2){
-    clause c;
     unsigned len = min(var1->size(), var2->size());
     for(size_t i=0;i<len;i++){
         innerEqualBit(var1->getAt(i), var2->getAt(i));
@@ -26,15 +25,11 @@ void blaster_solver::innerEqualVar(bvar var1, bvar var2){
     }
 }
 void blaster_solver::innerEqualBit(literal var1, literal var2){
-    clause c;
-    c.emplace_back(-var1);
-    c.emplace_back(var2);
-    addClause(c);
+    // a free variable is replaced, only two used ones need the clauses
+    if(merge(var1, var2)) return;
+    addClause2(-var1, var2);
 
-    c.clear();
-    c.emplace_back(var1);
-    c.emplace_back(-var2);
-    addClause(c);
+    addClause2(var1, -var2);
 }
 void blaster_solver::innerEqualInt(bvar var, bvar v){
     clause c;
@@ -64,74 +59,67 @@ void blaster_solver::innerEqualInt(bvar var, bvar v){
 }
 void blaster_solver::innerEqualBitInt(literal var, literal v){
     // var == v
-    clause c;
-    c.emplace_back(v==1?var:-var);
-    addClause(c);
+    addClause1(v==1?var:-var);
 }
-literal blaster_solver::EqualVar(bvar var1, bvar var2){
+literal blaster_solver::EqualVar(bvar var1, bvar var2, Polarity pol){
     literals lits;
     unsigned len = min(var1->size(), var2->size());
     for(size_t i=0;i<len;i++){
-        lits.emplace_back(EqualBit(var1->getAt(i), var2->getAt(i)));
+        lits.emplace_back(EqualBit(var1->getAt(i), var2->getAt(i), pol));
     }
     for(size_t i=len;i<var1->size();i++){
         // var2 extend sign bit
-        lits.emplace_back(EqualBit(var1->getAt(i), var2->signBit()));
+        lits.emplace_back(EqualBit(var1->getAt(i), var2->signBit(), pol));
     }
     for(size_t i=len;i<var2->size();i++){
         // var1 extend sign bit
-        lits.emplace_back(EqualBit(var2->getAt(i), var1->signBit()));
+        lits.emplace_back(EqualBit(var2->getAt(i), var1->signBit(), pol));
     }
 
-    return And(lits);
+    return And(lits, pol);
 }
 
-literal blaster_solver::EqualBool(const literal& lit1, const literal& lit2){
-    return EqualBit(lit1, lit2);
+literal blaster_solver::EqualBool(const literal& lit1, const literal& lit2, Polarity pol){
+    return EqualBit(lit1, lit2, pol);
 }
 
-literal blaster_solver::NotEqualBool(const literal& lit1, const literal& lit2){
-    return NotEqualBit(lit1, lit2);
+literal blaster_solver::NotEqualBool(const literal& lit1, const literal& lit2, Polarity pol){
+    return NotEqualBit(lit1, lit2, pol);
 }
-literal blaster_solver::EqualBit(literal var1, literal var2){
-    // t <-> var1 <-> var2
+literal blaster_solver::EqualBit(literal var1, literal var2, Polarity pol){
+    // t <-> var1 <-> var2, i.e. t == ~(var1 xor var2)
+    literal g = findXor(var1, var2, 0, negated(pol));
+    if(g!=0){
+        ++gatesHashed;
+        clausesSaved += 4;
+        return -g;
+    }
     bool_var t = newSatVar();
 
-    // t -> var1 -> var2
-    clause c;
-    c.emplace_back(-t);
-    c.emplace_back(-var1);
-    c.emplace_back(var2);
-    addClause(c);
+    if(pol & PolPos){
+        // t -> var1 -> var2
+        addClause3(-t, -var1, var2);
+
+        // t -> var2 -> var1
+        addClause3(-t, var1, -var2);
+    }
 
-    // t -> var2 -> var1
-    c.clear();
-    c.emplace_back(-t);
-    c.emplace_back(var1);
-    c.emplace_back(-var2);
-    addClause(c);
+    if(pol & PolNeg){
+        // var1 <-> var2 -> t
+        // not (not var1 or var2 and not var2 or var1) or t
+        // ( var1 /\ ~var2 \/ var2 /\ ~var1 ) \/ t
+        // ( var1 \/ var2 \/ t ) /\ (~var1 \/ ~var2 \/ t)
+        // ( var1 \/ var2 \/ t )
+        addClause3(t, var1, var2);
 
-    // var1 <-> var2 -> t
-    // not (not var1 or var2 and not var2 or var1) or t
-    // ( var1 /\ ~var2 \/ var2 /\ ~var1 ) \/ t
-    // ( var1 \/ var2 \/ t ) /\ (~var1 \/ ~var2 \/ t)
-    // ( var1 \/ var2 \/ t )
-    c.clear();
-    c.emplace_back(t);
-    c.emplace_back(var1);
-    c.emplace_back(var2);
-    addClause(c);
-    
-    // (~var1 \/ ~var2 \/ t)
-    c.clear();
-    c.emplace_back(t);
-    c.emplace_back(-var1);
-    c.emplace_back(-var2);
-    addClause(c);
+        // (~var1 \/ ~var2 \/ t)
+        addClause3(t, -var1, -var2);
+    }
+    keepXor(-t, var1, var2, 0, negated(pol));
     return t;
 }
-literal blaster_solver::EqualInt(bvar var, bvar v){
-    if(v->getCurValue()==0) return EqZero(var);
+literal blaster_solver::EqualInt(bvar var, bvar v, Polarity pol){
+    if(v->getCurValue()==0) return EqZero(var, pol);
     literals lits;
     unsigned len = min(var->size(), v->size());
     for(size_t i=0;i<len;i++){
@@ -147,7 +135,7 @@ literal blaster_solver::EqualInt(bvar var, bvar v){
         lits.emplace_back(EqualBitInt(var->signBit(), v->getAt(i)));
     }
 
-    return And(lits);
+    return And(lits, pol);
 }
 literal blaster_solver::EqualBitInt(literal var, literal v){
     // var == v
@@ -157,10 +145,10 @@ literal blaster_solver::EqualBitInt(literal var, literal v){
 literal blaster_solver::NotEqualVar(bvar var1, bvar var2){
     return -EqualVar(var1, var2);
 }
-literal blaster_solver::NotEqualBit(literal var1, literal var2){
-    return -EqualBit(var1, var2);
+literal blaster_solver::NotEqualBit(literal var1, literal var2, Polarity pol){
+    return -EqualBit(var1, var2, negated(pol));
 }
-literal blaster_solver::NotEqualInt(bvar var, bvar v){
+literal blaster_solver::NotEqualInt(bvar var, bvar v, Polarity pol){
     literals lits;
     unsigned len = min(var->size(), v->size());
     for(size_t i=0;i<len;i++){
@@ -175,7 +163,7 @@ literal blaster_solver::NotEqualInt(bvar var, bvar v){
         lits.emplace_back(NotEqualBitInt(var->signBit(), v->getAt(i)));
     }
 
-    return Or(lits);
+    return Or(lits, pol);
 }
 literal blaster_solver::NotEqualBitInt(literal var, literal v){
     // var == v
@@ -20,18 +20,20 @@ literal blaster_solver::Not(const literal&  l){
     else if(l==-Lit_False()) return Lit_False();
     return -l;
 }
-literal blaster_solver::And(const literal& lit1, const literal& lit2){
+literal blaster_solver::And(const literal& lit1, const literal& lit2, Polarity pol){
     literals lits{ lit1, lit2 };
-    return And(lits);
+    return And(lits, pol);
 }
-literal blaster_solver::Or(const literal& lit1, const literal& lit2){
+literal blaster_solver::Or(const literal& lit1, const literal& lit2, Polarity pol){
     literals lits{ lit1, lit2 };
-    return Or(lits);
+    return Or(lits, pol);
 }
-literal blaster_solver::And(const literals& lits){
+literal blaster_solver::And(const literals& lits, Polarity pol){
     assert(lits.size()>0);
     // simplify, except for -x and x
-    literals copy_lits(lits); std::sort(copy_lits.begin(), copy_lits.end());
+    literals copy_lits(lits);
+    for(size_t i=0;i<copy_lits.size();i++) copy_lits[i] = find(copy_lits[i]);
+    std::sort(copy_lits.begin(), copy_lits.end());
     literals ans;
     for(size_t i=0;i<copy_lits.size();i++){
         if(copy_lits[i]==solver->True()) continue;
@@ -44,30 +46,25 @@ literal blaster_solver::And(const literals& lits){
     if(ans.size()==0) return solver->True();
     else if(ans.size()==1) return ans[0];
 
-    bool_var t = newSatVar();
-
-    // t -> a /\ b <=> ~t \/ a /\ ~t \/ b
-    for(size_t i=0;i<ans.size();i++){
-        clause c;
-        c.emplace_back(-t);
-        c.emplace_back(ans[i]);
-        addClause(c);
+    literal g = findGate(GateAnd, ans.data(), ans.size(), pol);
+    if(g!=0){
+        ++gatesHashed;
+        clausesSaved += ans.size() + 1;
+        return g;
     }
 
-    // a /\ b -> t <=> t \/ ~a \/ ~b
-    clause c;
-    c.emplace_back(t);
-    for(size_t i=0;i<ans.size();i++){
-        c.emplace_back(-ans[i]);
-    }
-    addClause(c);
+    bool_var t = newSatVar();
+    emitGate(GateAnd, ans.data(), ans.size(), t, pol);
+    keepGate(GateAnd, ans.data(), ans.size(), t, pol);
 
     return t;
 }
-literal blaster_solver::Or(const literals& lits){
+literal blaster_solver::Or(const literals& lits, Polarity pol){
     assert(lits.size()>0);
     // simplify, except for -x and x
-    literals copy_lits(lits);std::sort(copy_lits.begin(), copy_lits.end());
+    literals copy_lits(lits);
+    for(size_t i=0;i<copy_lits.size();i++) copy_lits[i] = find(copy_lits[i]);
+    std::sort(copy_lits.begin(), copy_lits.end());
     literals ans;
     for(size_t i=0;i<copy_lits.size();i++){
         if(copy_lits[i]==solver->True()) return solver->True();
@@ -79,56 +76,198 @@ literal blaster_solver::Or(const literals& lits){
     }
     if(ans.size()==0) return solver->False();
     else if(ans.size()==1) return ans[0];
-    
-    bool_var t = newSatVar();
 
-    // t -> a \/ b <=> ~t \/ a \/ b
-    clause c;
-    c.emplace_back(-t);
-    for(size_t i=0;i<ans.size();i++){
-        c.emplace_back(ans[i]);
-    }
-    addClause(c);
-
-    // a \/ b -> t <=> ~a \/ t /\ ~b \/ t
-    c.clear();
-    for(size_t i=0;i<ans.size();i++){
-        c.emplace_back(t);
-        c.emplace_back(-ans[i]);
-        addClause(c);
-        c.clear();
+    // a \/ b == ~(~a /\ ~b)
+    literals neg(ans.rbegin(), ans.rend());
+    for(size_t i=0;i<neg.size();i++) neg[i] = -neg[i];
+    literal g = findGate(GateAnd, neg.data(), neg.size(), negated(pol));
+    if(g!=0){
+        ++gatesHashed;
+        clausesSaved += ans.size() + 1;
+        return -g;
     }
+    
+    bool_var t = newSatVar();
+    // ~t == ~a /\ ~b, so the sides of t swap.
+    emitGate(GateAnd, neg.data(), neg.size(), -t, negated(pol));
+    keepGate(GateAnd, neg.data(), neg.size(), -t, negated(pol));
 
     return t;
 }
-literal blaster_solver::Ite_bool(literal cond, literal ifp, literal elp){
+literal blaster_solver::Ite_bool(literal cond, literal ifp, literal elp, Polarity pol){
+    cond = find(cond); ifp = find(ifp); elp = find(elp);
+    // ite(~c, a, b) == ite(c, b, a)
+    if(cond<0){
+        cond = -cond;
+        std::swap(ifp, elp);
+    }
     // simplify
     if(cond==solver->True()) return ifp;
     else if(cond==solver->False()) return elp;
     else if(ifp==elp) return ifp;
+    // a known side leaves an and / or, e.g. the bits of constants
+    int ki = knownBit(ifp), ke = knownBit(elp);
+    if(ki==1) return Or(cond, elp, pol);
+    else if(ki==0) return And(Not(cond), elp, pol);
+    else if(ke==1) return Or(Not(cond), ifp, pol);
+    else if(ke==0) return And(cond, ifp, pol);
+    else if(cond==ifp) return Or(cond, elp, pol);
+    else if(cond==-ifp) return And(Not(cond), elp, pol);
+    else if(cond==elp) return And(cond, ifp, pol);
+    else if(cond==-elp) return Or(Not(cond), ifp, pol);
+
+    literal in[3] = {cond, ifp, elp};
+    literal g = findGate(GateIte, in, 3, pol);
+    if(g!=0){
+        ++gatesHashed;
+        clausesSaved += 6;
+        return g;
+    }
 
     bool_var t = newSatVar();
-    bool_var teqi = EqualBit(t, ifp);
-    bool_var teqe = EqualBit(t, elp);
-    
-    // cond -> teqi
-    clause c;
-    c.emplace_back(-cond);
-    c.emplace_back(teqi);
-    addClause(c);
-
-    // ~cond -> teqe
-    c.clear();
-    c.emplace_back(cond);
-    c.emplace_back(teqe);
-    addClause(c);
-
-    // teqi \/ teqe
-    c.clear();
-    c.emplace_back(teqi);
-    c.emplace_back(teqe);
-    addClause(c);
+    emitGate(GateIte, in, 3, t, pol);
+    keepGate(GateIte, in, 3, t, pol);
 
     return t;
 }
 
+// ------------structural hashing------------
+literal blaster_solver::findGate(GateKind k, const literal* in, unsigned n, Polarity pol){
+    gateKey.assign(1, (literal)k);
+    for(unsigned i=0;i<n;i++) gateKey.emplace_back(find(in[i]));
+    boost::unordered_map<literals, literal>::iterator it = GateMap.find(gateKey);
+    if(it==GateMap.end()) return 0;
+    literal out = it->second;
+    // a one-sided gate reused in another polarity gets the missing side.
+    boost::unordered_map<literal, int>::iterator s = GateSides.find(out);
+    if(s!=GateSides.end() && (pol & ~s->second)!=0){
+        Polarity missing = (Polarity)(pol & ~s->second);
+        s->second |= pol;
+        if(s->second==PolBoth) GateSides.erase(s);
+        emitGate(k, in, n, out, missing);
+    }
+    return out;
+}
+void blaster_solver::keepGate(GateKind k, const literal* in, unsigned n, literal out, Polarity pol){
+    gateKey.assign(1, (literal)k);
+    for(unsigned i=0;i<n;i++) gateKey.emplace_back(find(in[i]));
+    GateMap.insert(std::pair<literals, literal>(gateKey, out));
+    if(pol!=PolBoth) GateSides[out] = pol;
+}
+// the clauses of out <-> gate(in): pos for out -> gate, neg for gate -> out.
+void blaster_solver::emitGate(GateKind k, const literal* in, unsigned n, literal out, Polarity pol){
+    bool pos = (pol & PolPos)!=0, neg = (pol & PolNeg)!=0;
+    if(k==GateAnd){
+        // ~out \/ in[i]
+        if(pos) for(unsigned i=0;i<n;i++) addClause2(-out, in[i]);
+        // out \/ ~in[0] \/ ~in[1] ...
+        if(neg){
+            clause c;
+            c.emplace_back(out);
+            for(unsigned i=0;i<n;i++) c.emplace_back(-in[i]);
+            addClause(c);
+        }
+    }
+    else if(k==GateXor && n==2){
+        literal a = in[0], b = in[1];
+        if(pos){ addClause3(-out, a, b); addClause3(-out, -a, -b); }
+        if(neg){ addClause3(out, -a, b); addClause3(out, a, -b); }
+    }
+    else if(k==GateXor){
+        literal a = in[0], b = in[1], c = in[2];
+        if(pos){
+            addClause4(-out, a, b, c);   addClause4(-out, a, -b, -c);
+            addClause4(-out, -a, b, -c); addClause4(-out, -a, -b, c);
+        }
+        if(neg){
+            addClause4(out, a, b, -c);   addClause4(out, a, -b, c);
+            addClause4(out, -a, b, c);   addClause4(out, -a, -b, -c);
+        }
+    }
+    else if(k==GateMaj){
+        literal a = in[0], b = in[1], c = in[2];
+        if(pos){ addClause3(-out, a, b); addClause3(-out, a, c); addClause3(-out, b, c); }
+        if(neg){ addClause3(out, -a, -b); addClause3(out, -a, -c); addClause3(out, -b, -c); }
+    }
+    else{
+        // ite(c, a, b), the last clause of each side is redundant but propagates.
+        literal c = in[0], a = in[1], b = in[2];
+        if(pos){ addClause3(-out, -c, a); addClause3(-out, c, b); addClause3(-out, a, b); }
+        if(neg){ addClause3(out, -c, -a); addClause3(out, c, -b); addClause3(out, -a, -b); }
+    }
+}
+// xor keys on the variables, and the odd number of negations flips the output.
+static bool xorInputs(literal* in, unsigned n){
+    bool flip = false;
+    for(unsigned i=0;i<n;i++){
+        if(in[i]<0){
+            in[i] = -in[i];
+            flip = !flip;
+        }
+    }
+    std::sort(in, in + n);
+    return flip;
+}
+literal blaster_solver::findXor(literal a, literal b, literal c, Polarity pol){
+    literal in[3] = {a, b, c};
+    unsigned n = c==0?2:3;
+    bool flip = xorInputs(in, n);
+    literal g = findGate(GateXor, in, n, flip?negated(pol):pol);
+    if(g==0) return 0;
+    return flip?-g:g;
+}
+literal blaster_solver::findMaj(literal a, literal b, literal c){
+    // majority, self-dual: maj(~a, ~b, ~c) == ~maj(a, b, c)
+    literal in[3] = {a, b, c};
+    std::sort(in, in + 3);
+    literal g = findGate(GateMaj, in, 3);
+    if(g!=0) return g;
+    literal neg[3] = {-in[2], -in[1], -in[0]};
+    g = findGate(GateMaj, neg, 3);
+    return g==0?0:-g;
+}
+void blaster_solver::keepXor(literal out, literal a, literal b, literal c, Polarity pol){
+    literal in[3] = {a, b, c};
+    unsigned n = c==0?2:3;
+    bool flip = xorInputs(in, n);
+    keepGate(GateXor, in, n, flip?-out:out, flip?negated(pol):pol);
+}
+// out was made before the gate, so it is bound to the existing one.
+bool blaster_solver::hashedGate(literal out, literal gate, unsigned clauses){
+    if(gate==0) return false;
+    if(out!=gate) innerEqualBit(out, gate);
+    ++gatesHashed;
+    clausesSaved += clauses - 2;
+    return true;
+}
+
+
+// ------------known bits------------
+int blaster_solver::knownBit(literal l){
+    l = find(l);
+    if(l==solver->True() || l==-solver->False()) return 1;
+    if(l==solver->False() || l==-solver->True()) return 0;
+    return -1;
+}
+// the known inputs of a xor go to the parity, an equal pair cancels and
+// a complementary pair adds one.
+unsigned blaster_solver::foldXor(literal* in, unsigned n, bool& parity){
+    unsigned m = 0;
+    for(unsigned i=0;i<n;i++){
+        int k = knownBit(in[i]);
+        if(k>=0){
+            if(k==1) parity = !parity;
+            continue;
+        }
+        bool paired = false;
+        for(unsigned j=0;j<m;j++){
+            if(in[j]!=in[i] && in[j]!=-in[i]) continue;
+            if(in[j]==-in[i]) parity = !parity;
+            in[j] = in[--m];
+            paired = true;
+            break;
+        }
+        if(!paired) in[m++] = in[i];
+    }
+    return m;
+}
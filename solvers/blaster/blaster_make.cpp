@@ -39,6 +39,52 @@ bvar blaster_solver::mkInnerVar(const std::string& name, unsigned len){
     Escape(t);
     return t;
 }
+bvar blaster_solver::mkInnerVar(unsigned len){
+    bvar t = blast(mkPooled(len));
+    Escape(t);
+    return t;
+}
+// values in [lo, hi], unsigned when lo >= 0.
+bvar blaster_solver::mkInnerVar(unsigned len, const Integer& lo, const Integer& hi){
+    bvar t = lo<0?mkInnerVar(len):mkUnsigned(len);
+    setRange(t, lo, hi);
+    return t;
+}
+// unsigned: the sign bit is false, so there is no escape clause and the
+// sign extensions of the operations fold away.
+bvar blaster_solver::mkUnsigned(const std::string& name, unsigned len){
+    bvar t = nullptr;
+    if(n2var.find(name)!=n2var.end()){
+        t = n2var[name];
+        if(!t->isClean()) return t;
+        t->setSize(len);
+        t->reblast();
+    }
+    else{
+        t = new blast_variable(name, len);
+        n2var.insert(std::pair<std::string, bvar>(name, t));
+    }
+    t->setAt(0, solver->False());
+    for(size_t i=1;i<t->size();i++) t->setAt(i, newSatVar());
+    setRange(t, 0, upperOf(t));
+    return t;
+}
+bvar blaster_solver::mkUnsigned(unsigned len){
+    bvar t = mkPooled(len);
+    t->setAt(0, solver->False());
+    for(size_t i=1;i<t->size();i++) t->setAt(i, newSatVar());
+    setRange(t, 0, upperOf(t));
+    return t;
+}
+bvar blaster_solver::mkHolder(unsigned len){
+    return mkPooled(len);
+}
+bvar blaster_solver::mkPooled(unsigned len){
+    if(PoolUsed == Pool.size()) Pool.emplace_back("", 0);
+    bvar t = &Pool[PoolUsed++];
+    t->recycle(PoolUsed, len);
+    return t;
+}
 bvar blaster_solver::mkHolder(const std::string& name, unsigned len){
     if(n2var.find(name)!=n2var.end()){
         bvar x = n2var[name];
@@ -77,9 +123,11 @@ void blaster_solver::copy(bvar var, std::string& name, bvar& target){
     }
     else target->setSize(var->csize());
     target->reblast();
+    // the bits are substituted, the representatives of the literals of var
     for(size_t i=0;i<target->size();i++){
-        target->setAt(i, var->getAt(i));
+        target->setAt(i, var->isConstant()?var->getAt(i):find(var->getAt(i)));
     }
+    if(var->hasRange()) target->setRange(var->getLower(), var->getUpper());
 }
 void blaster_solver::copyInt(bvar var, bvar& target){
     if(target==nullptr){
@@ -94,12 +142,52 @@ void blaster_solver::copyInt(bvar var, bvar& target){
     }
 }
 void blaster_solver::Escape(bvar var){
+    scope s(this, OpEscape);
     clause c;
     c.emplace_back(-var->signBit());
     for(size_t i=1;i<var->size();i++){
         c.emplace_back(var->getAt(i));
     }
     addClause(c);
+    setRange(var, 1 - (Integer(1) << var->csize()), (Integer(1) << var->csize()) - 1);
+}
+// guard -> bits above len are the sign bit, i.e. var in [-2^len, 2^len-1].
+literal blaster_solver::Restrict(bvar var, unsigned len){
+    assert(!var->isConstant());
+    if(len + 1 >= var->size()) return solver->True();
+    literal guard = newSatVar();
+    for(size_t i=len+1;i<var->size();i++){
+        addClause3(-guard, -var->getAt(i), var->signBit());
+        addClause3(-guard, var->getAt(i), -var->signBit());
+    }
+    return guard;
+}
+// value ranges: each operation sizes its answer by the interval of its
+// result, computed from the ranges of its operands, and keeps the interval.
+Integer blaster_solver::lowerOf(bvar var) const{
+    if(var->isConstant()) return var->getCurValue();
+    if(var->hasRange()) return var->getLower();
+    return -(Integer(1) << var->csize());
+}
+Integer blaster_solver::upperOf(bvar var) const{
+    if(var->isConstant()) return var->getCurValue();
+    if(var->hasRange()) return var->getUpper();
+    return (Integer(1) << var->csize()) - 1;
+}
+void blaster_solver::setRange(bvar var, Integer lo, Integer hi){
+    if(var->isConstant()) return;
+    Integer l = lowerOf(var);
+    Integer u = upperOf(var);
+    if(lo < l) lo = l;
+    if(hi > u) hi = u;
+    var->setRange(lo, hi);
+    if(lo > 0 || hi < 0) var->unsetZero();
+}
+// the escaped -2^n is not used.
+unsigned blaster_solver::rangeWidth(const Integer& lo, const Integer& hi){
+    unsigned n = 1;
+    while(lo <= -(Integer(1) << n) || hi >= (Integer(1) << n)) ++n;
+    return n;
 }
 bvar blaster_solver::mkInt(Integer v){
     if(n2int.find(v.get_str())!=n2int.end()){
@@ -152,32 +240,37 @@ bool_var blaster_solver::mkBool(const std::string& name){
 
 // auxiliary make variable functions
 bvar blaster_solver::mkInvertedVar(bvar var){
-    std::string name = "inv("+var->getName()+")";
-    bvar t = mkHolder(name, var->csize());
+    bvar t = mkHolder(var->csize());
     for(size_t i=0;i<t->size();i++){
         t->setAt(i, -var->getAt(i));
     }
-    n2var.insert(std::pair<std::string, bvar>(t->getName(), t));
+    // ~x = -x - 1
+    if(var->hasRange()) setRange(t, -upperOf(var) - 1, -lowerOf(var) - 1);
     return t;
 }
 bvar blaster_solver::mkShiftedVar(bvar var, int len){
     if(len==0) return var;
     // len>0: shift right, len<0: shift left.
-    std::string name = "("+var->getName() + (len>0?">>":"<<") + to_string(abs(len))+")";
-    bvar t = mkHolder(name, var->csize()-len);
-    t->setAt(0, var->signBit());
+    bvar t = nullptr;
     if(len>0){
-       for(size_t i=1;i<t->size();i++){
+        // the floor of a negative value may be -2^(csize-len), so the sign
+        // is extended into one more bit instead of an escape.
+        t = mkHolder(var->csize()-len+1);
+        t->setAt(0, var->signBit());
+        for(size_t i=1;i+1<t->size();i++){
             t->setAt(i, var->getAt(i+len));
         }
-        Escape(t);
+        t->setAt(t->size()-1, var->signBit());
+        if(var->hasRange()) setRange(t, lowerOf(var) >> len, upperOf(var) >> len);
     }
     else{
+        t = mkHolder(var->csize()-len);
+        t->setAt(0, var->signBit());
         len = -len;
         for(int i=1;i<=len;i++) t->setAt(i, solver->False());
         for(size_t i=len+1;i<t->size();i++) t->setAt(i, var->getAt(i-len));
+        if(var->hasRange()) setRange(t, lowerOf(var) << len, upperOf(var) << len);
     }
-    n2var.insert(std::pair<std::string, bvar>(name, t));
     return t;
 }
 bool_var blaster_solver::newSatVar(){
@@ -8,6 +8,8 @@
 #include "solvers/blaster/blaster_solver.hpp"
 #include "solvers/blaster/blaster_bits.hpp"
 
+#include <algorithm>
+
 using namespace ismt;
 
 
@@ -18,54 +20,55 @@ bvar blaster_solver::Negate(bvar var){
         return mkInt(-var->getCurValue());
     }
     bvar t = Invert(var);
-    bvar ans = AddOne(t);
-    ans->setName("(-"+var->getName()+")");
-    return ans;
+    return AddOne(t);
 }
 bvar blaster_solver::Absolute(bvar var){
+    scope s(this, OpAbsolute);
     if(var->isConstant()){
         if(var->signBit()==1) return Negate(var);
         else return var;
     }
-    bvar neg = Negate(var);
-    // var->SignBit() == 1?(-var):var. 
-    return Ite_num(var->signBit(), neg, var);
+    Integer lo = lowerOf(var);
+    Integer hi = upperOf(var);
+    if(lo >= 0) return var;
+    else if(hi <= 0) return Negate(var);
+    // conditional negation in one pass by the sign.
+    Integer m = std::max(Integer(-lo), hi);
+    bvar answer = mkHolder(rangeWidth(0, m));
+    answer->setAt(0, solver->False());
+    literals bits;
+    for(size_t i=1;i<answer->size();i++) bits.emplace_back(bitOf(var, i));
+    NegateIf(var->signBit(), bits);
+    for(size_t i=0;i<bits.size();i++) answer->setAt(i+1, bits[i]);
+    setRange(answer, 0, m);
+    return answer;
 }
 bvar blaster_solver::Subtract(bvar var1, bvar var2){
-    return Add(var1, Negate(var2));
+    if(var2->isConstant()) return Add(var1, mkInt(-var2->getCurValue()));
+    auto it = DiffMap.find(std::make_pair(var1, var2));
+    if(it != DiffMap.end()) return it->second;
+    // var1 + ~var2 + 1 in one adder
+    bvar ans = Add(var1, Invert(var2), false, true);
+    DiffMap.insert(std::make_pair(std::make_pair(var1, var2), ans));
+    return ans;
 }
 bvar blaster_solver::Ite_num (literal cond, bvar ifp, bvar elp){
+    scope s(this, OpIteNum);
     if(cond==solver->True()) return ifp;
     else if(cond==solver->False()) return elp;
+    else if(ifp==elp) return ifp;
     
-    bvar tmp = mkInnerVar("ite("+to_string(cond)+","+ifp->getName()+","+elp->getName()+")", 
-                    max(ifp->csize(), elp->csize()));
-    
-    // debug: 2021-11-08, it can be integer.
-    bool_var teqi;bool_var teqe;
-    if(ifp->isConstant()) teqi = viEq(tmp, ifp);
-    else teqi = vvEq(tmp, ifp);
-    if(elp->isConstant()) teqe = viEq(tmp, elp);
-    else teqe = vvEq(tmp, elp);
-
-    // cond -> teqi
-    clause c;
-    c.emplace_back(-cond);
-    c.emplace_back(teqi);
-    addClause(c);
-
-    // ~cond -> teqe
-    c.clear();
-    c.emplace_back(cond);
-    c.emplace_back(teqe);
-    addClause(c);
-
-    // teqi \/ teqe
-    c.clear();
-    c.emplace_back(teqi);
-    c.emplace_back(teqe);
-    addClause(c);
-
+    Integer lo = std::min(lowerOf(ifp), lowerOf(elp));
+    Integer hi = std::max(upperOf(ifp), upperOf(elp));
+    unsigned len = std::min((unsigned)max(ifp->csize(), elp->csize()), rangeWidth(lo, hi));
+    // a multiplexer per bit, both values fit in len bits. the bits the
+    // sides share, e.g. of constants, fold.
+    bvar tmp = mkHolder(len);
+    tmp->setAt(0, lo<0?Ite_bool(cond, bitOf(ifp, 0), bitOf(elp, 0)):solver->False());
+    for(size_t i=1;i<tmp->size();i++){
+        tmp->setAt(i, Ite_bool(cond, bitOf(ifp, i), bitOf(elp, i)));
+    }
+    setRange(tmp, lo, hi);
     return tmp;
 }
 
@@ -75,95 +78,174 @@ bvar blaster_solver::Ite_num (literal cond, bvar ifp, bvar elp){
 // ACM Transactions on Programming Languages and Systems (TOPLAS) 
 // ACM Press. 14 (2): 127 - 144. doi:10.1145/128861.128862.
 bvar blaster_solver::Divide(bvar var1, bvar var2){
+    scope s(this, OpDivide);
     // -3 / 2 = -2 ... 1
     // -2 / 3 = -1 ... 1
     // 3 / -2 = -1 ... 1
     // 2 / -3 =  0 ... 2
     // -3 / -2 = 2 ... 1
     // -2 / -3 = 1 ... 1
-    if(var1->isConstant()&&var2->isConstant()){
-        return mkInt(var1->getCurValue()/var2->getCurValue());
+    bool zero = var2->isConstant() && var2->getCurValue()==0; // unspecified, see DivMod
+    if(!zero && var1->isConstant()&&var2->isConstant()){
+        return mkInt(euclid_div(var1->getCurValue(), var2->getCurValue()));
     }
     // some cases can simplify.
     if(var1->isConstant()){
-        if(var1->getCurValue()==0) return mkInt(0);
+        if(!zero && var1->getCurValue()==0) return mkInt(0);
     }
-    else if(var2->isConstant()){
-        if(var2->getCurValue()==0) outputError("Divided by 0!");
-        else if(var2->getCurValue()==1) return var1;
+    else if(var2->isConstant() && !zero){
+        if(var2->getCurValue()==1) return var1;
         else if(var2->getCurValue()==-1) return Negate(var1);
-        else if(divideZero(var2->getCurValue()) >= var1->csize()) return mkInt(0); // 2 / 4 = 0. 
-        else if(var2->getCurValue()%2==0){
-            Integer num = var2->getCurValue();
-            unsigned len = compress(num);
-            
-            // debug: 2021.11.27
-            // -1(11111) >> 1 = (-1)1111, it will never change.
-            bvar stmp = Shift(var1, len);
-            bvar tmp = nullptr;
-            if(num==1) tmp = stmp;
-            else if(num==-1) tmp = Negate(stmp);
-            else tmp = Divide(stmp, mkInt(num));
-            if(var2->getCurValue()<0){
-                // 2 / -3 =  0 ... 2
-                return Ite_num(And(viGt(Absolute(var2), Absolute(var1)), GeZero(var1)), mkInt(0), tmp);
-            }
-            else{
-                // -3 / 2 = -2 ... 1
-                // -2 / 3 = -1 ... 1
-                // 3 / -2 = -1 ... 1
-                // -3 / -2 = 2 ... 1
-                // -2 / -3 = 1 ... 1
-                return tmp;
-            }
-        }
+        else if(lowerOf(var1)>=0 && divideZero(var2->getCurValue()) >= var1->csize()) return mkInt(0); // 2 / 4 = 0, but -2 / 4 = -1.
         // if var1 = x - 32(from left bound), var1 >> 3 ? do like z3?
     }
-    bvar abv2 = Absolute(var2);
-    // TODO, can simplify?
-    bvar q = Ite_num(vvGt(abv2, Absolute(var1)), mkInt(0), mkInnerVar("("+var1->getName()+"/"+var2->getName()+")", var1->csize()));
-    bvar r = mkInnerVar("("+var1->getName()+"%"+var2->getName()+")", var2->csize());
-    
-    // must use /, once letvar use /, we may not multiply to integer.
-    // special cases
-    if(var1->isConstant() || var2->isConstant()){
-        innerEqualBit((var1->isConstant()?viEq(Negate(var1), var2):viEq(var1, Negate(var2))), And(EqualInt(q, mkInt(-1)), EqualInt(r, mkInt(0))));
-        innerEqualBit(viEq(var1, var2), And(EqualInt(q, mkInt(1)), EqualInt(r, mkInt(0))));
-    }
-    else{
-        innerEqualBit(Or(vvEq(Negate(var1), var2), vvEq(var1, Negate(var2))), And(EqualInt(q, mkInt(-1)), EqualInt(r, mkInt(0))));
-        innerEqualBit(vvEq(var1, var2), And(EqualInt(q, mkInt(1)), EqualInt(r, mkInt(0))));
-    }
-    innerEqualVar(Add(Multiply(var2, q), r), var1);
-    if(!var2->isConstant()) innerEqualBitInt(NeqZero(var2), 1); // var2 != 0
-    innerEqualBitInt(GeZero(r), 1); // r >= 0
-    // TODO, -3 / 2 = -2 ... 1
-    // Greater(r, Negate(abv2)); // r > -var2
-    innerEqualBitInt(Less(r, abv2), 1); // r < var2 
+    bvar q = nullptr, r = nullptr;
+    DivMod(var1, var2, q, r);
     return q;
 }
 bvar blaster_solver::Modulo(bvar var1, bvar var2){
-    if(var1->isConstant()&&var2->isConstant()){
-        return mkInt(var1->getCurValue()%var2->getCurValue());
+    scope s(this, OpModulo);
+    bool zero = var2->isConstant() && var2->getCurValue()==0; // unspecified, see DivMod
+    if(!zero && var1->isConstant()&&var2->isConstant()){
+        return mkInt(euclid_mod(var1->getCurValue(), var2->getCurValue()));
     }
     // some cases can simplify.
     if(var1->isConstant()){
-        if(var1->getCurValue()==0) return mkInt(0);
+        if(!zero && var1->getCurValue()==0) return mkInt(0);
     }
-    else if(var2->isConstant()){
-        if(var2->getCurValue()==0) outputError("Modulo by 0!");
-        else if(var2->getCurValue()==1) return mkInt(0);
-        else if(divideZero(var2->getCurValue()) >= var1->csize()) return var1; // 2 % 4 = 2.
+    else if(var2->isConstant() && !zero){
+        if(var2->getCurValue()==1 || var2->getCurValue()==-1) return mkInt(0);
+        else if(lowerOf(var1)>=0 && divideZero(var2->getCurValue()) >= var1->csize()) return var1; // 2 % 4 = 2, but -2 % 4 = 2.
     }
-
-    bvar q = Ite_num(vvGt(Absolute(var2),Absolute(var1)), mkInt(0), mkInnerVar("("+var1->getName()+"/"+var2->getName()+")", var1->size() - var2->size() + 1));
-    bvar r = mkInnerVar("("+var1->getName()+"%"+var2->getName()+")", var2->size());
-    innerEqualVar(Add(Multiply(var2, q), r), var1);
-    if(!var2->isConstant()) innerEqualBitInt(NeqZero(var2), 1); // var2 != 0
-    innerEqualBitInt(GeZero(r), 1); // r >= 0
-    innerEqualBitInt(Less(r, Absolute(var2)), 1); // r < var2 
+    bvar q = nullptr, r = nullptr;
+    DivMod(var1, var2, q, r);
     return r;
-
+}
+// both div and mod of the same operands come here, and share q and r.
+void blaster_solver::DivMod(bvar var1, bvar var2, bvar& q, bvar& r){
+    auto it = DivMap.find(std::make_pair(var1, var2));
+    if(it != DivMap.end()){
+        q = it->second.first;
+        r = it->second.second;
+        return;
+    }
+    if(var2->isConstant()){
+        if(var2->getCurValue()==0){
+            // smt-lib leaves x div 0 and x mod 0 unspecified: fresh values,
+            // the same ones for the same x by the cache.
+            q = mkInnerVar(std::max(default_len, var1->csize()));
+            r = mkInnerVar(std::max(default_len, var1->csize()));
+        }
+        else if(var2->getCurValue()%2==0){
+            // debug: 2021.11.27
+            // -1(11111) >> 1 = (-1)1111, it will never change.
+            // the shift floors: x = 2^len * (x >> len) + low and (x >> len) = q * num + r1
+            // for either sign of num, so r is r1 above the low len bits of x.
+            Integer num = var2->getCurValue();
+            unsigned len = compress(num);
+            bvar stmp = Shift(var1, len);
+            bvar r1 = nullptr;
+            if(num==1){ q = stmp; r1 = mkInt(0); }
+            else if(num==-1){ q = Negate(stmp); r1 = mkInt(0); }
+            else DivMod(stmp, mkInt(num), q, r1);
+            r = mkHolder(len + r1->csize());
+            r->setAt(0, solver->False());
+            for(size_t i=1;i<r->size();i++) r->setAt(i, i<=len?bitOf(var1, i):bitOf(r1, i - len));
+            setRange(r, 0, abs(var2->getCurValue()) - 1);
+        }
+        else DivModInt(var1, var2, q, r);
+        DivMap.insert(std::make_pair(std::make_pair(var1, var2), std::make_pair(q, r)));
+        return;
+    }
+    innerEqualBitInt(NeqZero(var2), 1); // var2 != 0
+    // |x| = qa * |y| + ra by a divider of the magnitudes.
+    bvar abv1 = Absolute(var1);
+    bvar abv2 = Absolute(var2);
+    literals a, b, qa, ra;
+    for(size_t i=1;i<abv1->size();i++) a.emplace_back(bitOf(abv1, i));
+    for(size_t i=1;i<abv2->size();i++) b.emplace_back(bitOf(abv2, i));
+    RestoringDivide(a, b, qa, ra);
+
+    // the euclidean sign correction, once: a negative x with a remainder
+    // takes one more |y|, so qa + 1 and r = |y| - ra; q has the sign of x * y.
+    literal sx = lowerOf(var1)>=0?solver->False():bitOf(var1, 0);
+    literal sy = lowerOf(var2)>=0?solver->False():bitOf(var2, 0);
+    literal up = AndGate(sx, Or(ra));
+    // qa + up fits: with a remainder |y| > 1, so qa < |x|.
+    literal cry = up;
+    for(size_t i=0;i<qa.size();i++){
+        literal x = qa[i];
+        qa[i] = XorGate(x, cry);
+        if(i+1<qa.size()) cry = AndGate(x, cry);
+    }
+    literal neg = XorGate(sx, sy);
+    literal zero = NegateIf(neg, qa, true);
+    Integer m1 = std::max(Integer(abs(lowerOf(var1))), Integer(abs(upperOf(var1))));
+    q = mkHolder(qa.size());
+    q->setAt(0, AndGate(neg, Not(zero))); // -0 = 0
+    for(size_t i=0;i<qa.size();i++) q->setAt(i+1, qa[i]);
+    setRange(q, neg==solver->False()?Integer(0):Integer(-m1), m1);
+
+    // |y| - ra, ra < |y|
+    Integer m2 = std::max(Integer(abs(lowerOf(var2))), Integer(abs(upperOf(var2))));
+    r = mkHolder(ra.size());
+    r->setAt(0, solver->False());
+    cry = solver->True();
+    for(size_t i=0;i<ra.size();i++){
+        literal d = XorGate(b[i], Not(ra[i]), cry);
+        if(i+1<ra.size()) cry = MajGate(b[i], Not(ra[i]), cry);
+        r->setAt(i+1, Ite_bool(up, d, ra[i]));
+    }
+    setRange(r, 0, m2 - 1);
+    DivMap.insert(std::make_pair(std::make_pair(var1, var2), std::make_pair(q, r)));
+}
+// a constant divisor: x = q * c + r is a product by a constant, cheaper than a divider.
+void blaster_solver::DivModInt(bvar var1, bvar var2, bvar& q, bvar& r){
+    Integer c = abs(var2->getCurValue());
+    // |q| <= |var1|
+    Integer m1 = std::max(Integer(abs(lowerOf(var1))), Integer(abs(upperOf(var1))));
+    q = mkInnerVar(std::min(var1->csize(), rangeWidth(-m1, m1)));
+    // 0 <= r < |var2|
+    r = mkUnsigned(rangeWidth(0, c - 1));
+    innerEqualVar(Add(Multiply(var2, q), r), var1);
+    innerEqualBitInt(Less(r, mkInt(c)), 1); // r < |var2|
+    // only now, the product is sized by the range of q
+    setRange(q, -m1, m1);
+    setRange(r, 0, c - 1);
+}
+// restoring division of unsigned bits, least significant first, b != 0.
+// a row per bit of a from the top: shift it into the partial remainder,
+// subtract b, the carry out is the quotient bit and picks the remainder.
+void blaster_solver::RestoringDivide(const literals& a, const literals& b, literals& q, literals& r){
+    q.assign(a.size(), solver->False());
+    r.assign(b.size(), solver->False());
+    literals rem(b.size() + 1);
+    literals diff(b.size());
+    for(size_t i=a.size();i-->0;){
+        // rem = r * 2 + a[i] < 2 * b
+        rem[0] = a[i];
+        for(size_t j=0;j<r.size();j++) rem[j+1] = r[j];
+        // rem - b as rem + ~b + 1, the high bit of the difference is 0 when it fits
+        literal cry = solver->True();
+        for(size_t j=0;j<rem.size();j++){
+            literal nb = j<b.size()?Not(b[j]):solver->True();
+            if(j<diff.size()) diff[j] = XorGate(rem[j], nb, cry);
+            cry = MajGate(rem[j], nb, cry);
+        }
+        q[i] = cry; // rem >= b
+        for(size_t j=0;j<r.size();j++) r[j] = Ite_bool(cry, diff[j], rem[j]);
+    }
+}
+// two's complement negation of bits if s: bits xor s plus the carry s,
+// which runs up to the lowest one bit. carry: return the carry out, s and bits = 0.
+literal blaster_solver::NegateIf(literal s, literals& bits, bool carry){
+    literal cry = s;
+    for(size_t i=0;i<bits.size();i++){
+        literal x = bits[i];
+        bits[i] = XorGate(x, s, cry);
+        if(carry || i+1<bits.size()) cry = AndGate(cry, Not(x));
+    }
+    return carry?cry:0;
 }
 // main functions, add and multiply.
 bvar blaster_solver::Add(bvar var1, bvar var2){
@@ -177,6 +259,7 @@ bvar blaster_solver::Add(bvar var1, bvar var2){
     return Add(var1, var2, false);
 }
 bvar blaster_solver::Multiply(bvar var1, bvar var2){
+    scope s(this, OpMultiply);
     if(var1->isConstant() && var2->isConstant()) 
         return mkInt(var1->getCurValue() * var2->getCurValue());
     assert(!var1->isConstant() || !var2->isConstant());
@@ -185,49 +268,52 @@ bvar blaster_solver::Multiply(bvar var1, bvar var2){
         if(var1->getCurValue()==0) return mkInt(0);
         else if(var1->getCurValue()==1) return var2;
         else if(var1->getCurValue()==-1) return Negate(var2);
-        else if(var1->getCurValue()%2==0){
-            Integer num = var1->getCurValue();
-            unsigned len = compress(num);
-            bvar stmp = Shift(var2, -(int)len);
-            if(num==1) return stmp;
-            else return Multiply(stmp, mkInt(num));
-        }
-        // mk it positive.
-        if(var1->getCurValue()<0){
-            var2 = Negate(var2);
-            var1 = mkInt(-var1->getCurValue());
-        }
-        assert(var1->getCurValue()>0);
         return MultiplyInt(var2, var1);
     }
     else if(var2->isConstant()){
         if(var2->getCurValue()==0) return mkInt(0);
         else if(var2->getCurValue()==1) return var1;
         else if(var2->getCurValue()==-1) return Negate(var1);
-        else if(var2->getCurValue()%2==0){
-            Integer num = var2->getCurValue();
-            unsigned len = compress(num);
-            bvar stmp = Shift(var1, -(int)len);
-            if(num==1) return stmp;
-            else return Multiply(stmp, mkInt(num));
-        }
-        // mk it positive.
-        if(var2->getCurValue()<0){
-            var1 = Negate(var1);
-            var2 = mkInt(-var2->getCurValue());
-        }
-        assert(var2->getCurValue()>0);
         return MultiplyInt(var1, var2);
     }
     // they are both variables.
     bvar varmax;bvar varmin;
     if(var1->size()>=var2->size()){varmax = var1; varmin = var2;}
     else{varmax = var2; varmin = var1;}
-    unsigned len = var1->csize() + var2->csize();
-    bvar answer = mkInnerVar("("+var1->getName()+"*"+ var2->getName()+")", len);
-    if(var1==var2){
-        // square
-        innerEqualBitInt(answer->signBit(), 0); // square, then must positive.
+    if(var1==var2) return Square(var1);
+    // the product modulo 2^(len+1), len from the range of the product
+    Integer corners[4] = {
+        lowerOf(var1) * lowerOf(var2), lowerOf(var1) * upperOf(var2),
+        upperOf(var1) * lowerOf(var2), upperOf(var1) * upperOf(var2)
+    };
+    Integer lo = *std::min_element(corners, corners + 4);
+    Integer hi = *std::max_element(corners, corners + 4);
+    unsigned len = std::min(var1->csize() + var2->csize(), std::max(rangeWidth(lo, hi), varmin->csize()));
+    bool tree = mulMode==WallaceMul || mulMode==DaddaMul ||
+                (mulMode==AutoMul && varmin->csize()>=tree_width);
+    // the bits of the array are the literals of its partial sums, only the
+    // tree sums into variables of its own.
+    bvar answer = nullptr;
+    if(tree) answer = mkInnerVar(len, lo, hi);
+    else{
+        answer = mkHolder(len);
+        answer->setAt(0, lo<0?newSatVar():solver->False());
+        setRange(answer, lo, hi);
+        bvar subsum = MultiplyBit(varmax, varmin->getAt(1), len); // varmax * varmin[1]
+        for(size_t i=2;i<varmin->size();i++){
+            bvar subans = MultiplyBit(varmax, varmin->getAt(i), len+1-i);
+            subsum = ShiftAdd(subsum, subans, answer, i);
+        }
+        for(size_t i=varmin->size();i<answer->size();i++){
+            // extend the varmin's signbit.
+            bvar subans = MultiplyBit(varmax, varmin->signBit(), len+1-i);
+            subsum = ShiftAdd(subsum, subans, answer, i);
+        }
+        answer->setAt(len, subsum->getAt(1));
+        if(lo<0) Escape(answer);
+    }
+    if(answer->signBit()==solver->False()){
+        // unsigned product, no sign bit to compute
     }
     else if(!varmax->hasZero() && !varmin->hasZero()){// both variables cannot be zero
         doTargetInt(answer->signBit(), varmax->signBit(), 0, varmin->signBit()); // sign bit
@@ -248,193 +334,136 @@ bvar blaster_solver::Multiply(bvar var1, bvar var2){
         doTargetInt(t, varmax->signBit(), 0, varmin->signBit()); // sign bit: t = xor(varmax->signBit(), varmin->signBit());
         innerEqualBit(answer->signBit(), Ite_bool(tt, solver->False(), t));
     }
-    bvar subsum = MultiplyBit(varmax, varmin->getAt(1), len); // varmax * varmin[1]
-    for(size_t i=2;i<varmin->size();i++){
-        bvar subans = MultiplyBit(varmax, varmin->getAt(i), len+1-i);
-        subsum = ShiftAdd(subsum, subans, answer, i);
-    }
-    for(size_t i=varmin->size();i<answer->size();i++){
-        // extend the varmin's signbit.
-        bvar subans = MultiplyBit(varmax, varmin->signBit(), len+1-i);
-        subsum = ShiftAdd(subsum, subans, answer, i);
-    }
-    innerEqualBit(subsum->getAt(1), answer->getAt(len));
+    if(tree) MultiplyTree(varmax, varmin, answer, mulMode!=WallaceMul);
     return answer;
 }
 
 // auxiliary functions for math operations
-bvar blaster_solver::Add(bvar var1, bvar var2, bool addone){
-    bvar varmax;bvar varmin;
-    if(var1->size()>=var2->size()) varmax = var1, varmin = var2;
-    else varmax = var2, varmin = var1;
+bvar blaster_solver::Add(bvar var1, bvar var2, bool addone, bool carry){
+    scope s(this, OpAdd);
+    bvar varmax = var1->size()>=var2->size()?var1:var2;
     unsigned size = 0;
     if(addone) size = varmax->csize();
     else size = varmax->size();
-    bvar cry = mkInnerVar("auxVar_addcry("+ to_string(auxSize++) +")", size+1);
-    bvar answer = mkInnerVar("auxVar_addans("+ to_string(auxSize++) +")", size);
-    innerEqualBitInt(cry->signBit(), 0);
-    innerEqualBitInt(cry->getAt(1), 0);
-    // if one is constant
-    if(var1->isConstant() || var2->isConstant()){
-        bvar var;bvar v;
-        if(var1->isConstant()) var = var2, v = var1;
-        else var = var1, v = var2;
-
-        // lower bits of var + v
-        for(size_t i=1;i<varmin->size();i++){ // answer[1,...,lenmin-1]
-            doTargetInt(answer->getAt(i), var->getAt(i), v->getAt(i), cry->getAt(i));
-        }
-        for(size_t i=1;i<varmin->size();i++){ // carry[2,...,lenmin]
-            doCarryInt(cry->getAt(i+1), var->getAt(i), v->getAt(i), cry->getAt(i));
-        }
-        if(var->size()>=v->size()){
-            // upper bits adding: extend v with its sign bit
-            for(size_t i=varmin->size();i<varmax->size();i++){ // answer[lenmin, ..., lenmax]
-                doTargetInt(answer->getAt(i), var->getAt(i), v->signBit(), cry->getAt(i));
-            }
-            for(size_t i=varmin->size();i<varmax->size();i++){ // carry[lenmin+1, ..., lenmax+1]
-                doCarryInt(cry->getAt(i+1), var->getAt(i), v->signBit(), cry->getAt(i));
-            }
-            // upper bits adding: extend var, v with its sign bit
-            for(size_t i=varmax->size();i<answer->size();i++){ // answer[lenmin, ..., size]
-                doTargetInt(answer->getAt(i), var->signBit(), v->signBit(), cry->getAt(i));
-            }
-            for(size_t i=varmax->size();i<answer->size();i++){ // carry[lenmin+1, ..., size+1]
-                doCarryInt(cry->getAt(i+1), var->signBit(), v->signBit(), cry->getAt(i));
-            }
-        }
-        else{ // var->size()<v->size()
-            // upper bits adding: extend var with its sign bit
-            for(size_t i=varmin->size();i<varmax->size();i++){ // answer[lenmin, ..., lenmax]
-                doTargetInt(answer->getAt(i), var->signBit(), v->getAt(i), cry->getAt(i));
-            }
-            for(size_t i=varmin->size();i<varmax->size();i++){ // carry[lenmin+1, ..., lenmax+1]
-                doCarryInt(cry->getAt(i+1), var->signBit(), v->getAt(i), cry->getAt(i));
-            }
-            // upper bits adding: extend var, v with its sign bit
-            for(size_t i=varmax->size();i<answer->size();i++){ // answer[lenmin, ..., size]
-                doTargetInt(answer->getAt(i), var->signBit(), v->signBit(), cry->getAt(i));
-            }
-            for(size_t i=varmax->size();i<answer->size();i++){ // carry[lenmin+1, ..., size+1]
-                doCarryInt(cry->getAt(i+1), var->signBit(), v->signBit(), cry->getAt(i));
-            }
-        }
-        // calculate sign bit of answer
-        // 2021.11.13, if use as add one, the sign bit will not change.
-        // if(addone) innerEqualBit(answer->signBit(), var->signBit());
-        // else doTargetInt(answer->signBit(), var->signBit(), v->signBit(), cry->getAt(size+1));
-        doTargetInt(answer->signBit(), var->signBit(), v->signBit(), cry->getAt(size+1));
-    }
-    else{ // they are both variables.
-        // lower bits of varmax + varmin    
-        for(size_t i=1;i<varmin->size();i++){ // answer[1,...,lenmin-1]
-            doTarget(answer->getAt(i), varmax->getAt(i), varmin->getAt(i), cry->getAt(i));
-        }
-        for(size_t i=1;i<varmin->size();i++){ // carry[2,...,lenmin]
-            doCarry(cry->getAt(i+1), varmax->getAt(i), varmin->getAt(i), cry->getAt(i));
-        }
-
-        // upper bits adding: extend varmin with its sign bit
-        for(size_t i=varmin->size();i<varmax->size();i++){ // answer[lenmin, ..., lenmax]
-            doTarget(answer->getAt(i), varmax->getAt(i), varmin->signBit(), cry->getAt(i));
-        }
-        for(size_t i=varmin->size();i<varmax->size();i++){ // carry[lenmin+1, ..., lenmax+1]
-            doCarry(cry->getAt(i+1), varmax->getAt(i), varmin->signBit(), cry->getAt(i));
-        }
-
-        // upper bits adding: extend varmax, varmin with its sign bit
-        for(size_t i=varmax->size();i<answer->size();i++){ // answer[lenmin, ..., lenmax]
-            doTarget(answer->getAt(i), varmax->signBit(), varmin->signBit(), cry->getAt(i));
+    // the sum is computed modulo 2^(size+1), as wide as its range needs
+    Integer lo = lowerOf(var1) + lowerOf(var2) + (carry?1:0);
+    Integer hi = upperOf(var1) + upperOf(var2) + (carry?1:0);
+    unsigned width = rangeWidth(lo, hi);
+    if(width < size) size = std::max(width, varmax->csize());
+    // a ripple of gates over the sign extended bits, so the known bits of
+    // the operands, e.g. of a constant or a shift, fold with their carries
+    // and the answer reuses their literals.
+    bvar answer = mkHolder(size);
+    literal cry = carry?solver->True():solver->False();
+    for(size_t i=1;i<answer->size();i++){
+        literal x = bitOf(var1, i);
+        literal y = bitOf(var2, i);
+        answer->setAt(i, XorGate(x, y, cry));
+        if(i+1<answer->size() || lo<0) cry = MajGate(x, y, cry);
+    }
+    // a non-negative sum is unsigned
+    answer->setAt(0, lo<0?XorGate(bitOf(var1, 0), bitOf(var2, 0), cry):solver->False());
+    // all bits known, e.g. x + ~x, the sign as well
+    Integer v = 0;
+    for(size_t i=answer->size()-1;i>0 && knownBit(answer->signBit())>=0;i--){
+        int k = knownBit(answer->getAt(i));
+        if(k<0) break;
+        v = v * 2 + k;
+        if(i==1) return mkInt(knownBit(answer->signBit())==1?v - (Integer(1) << size):v);
+    }
+    setRange(answer, lo, hi);
+    return answer;
+}
+// an n-ary sum as one carry-save tree: the bits of all operands are laid
+// out by column and reduced as in the multipliers, then a single adder.
+// an operand of csize w is sign extended as ~s at column w plus the
+// constant -2^w, and the constants are folded into one whose bits are true.
+// the answer is as wide as the bound of the sum, its top column is the sign.
+bvar blaster_solver::AddMulti(const std::vector<bvar>& vars){
+    scope s(this, OpAddMulti);
+    std::vector<bvar> terms;
+    Integer constant = 0;
+    for(size_t i=0;i<vars.size();i++){
+        if(vars[i]->isConstant()) constant += vars[i]->getCurValue();
+        else terms.emplace_back(vars[i]);
+    }
+    if(terms.size()==0) return mkInt(constant);
+    else if(terms.size()==1) return Add(terms[0], mkInt(constant));
+    else if(terms.size()==2 && constant==0) return Add(terms[0], terms[1]);
+    // the range of the sum
+    Integer lo = constant;
+    Integer hi = constant;
+    for(size_t i=0;i<terms.size();i++){
+        lo += lowerOf(terms[i]);
+        hi += upperOf(terms[i]);
+    }
+    unsigned len = rangeWidth(lo, hi);
+    // the columns 0..len, the bits above are dropped
+    std::vector<literals> cols(len+1);
+    for(size_t i=0;i<terms.size();i++){
+        bvar t = terms[i];
+        for(size_t j=1;j<t->size() && j<=len+1;j++){
+            if(t->getAt(j)!=solver->False()) cols[j-1].emplace_back(t->getAt(j));
         }
-        for(size_t i=varmax->size();i<answer->size();i++){ // carry[lenmin+1, ..., lenmax+1]
-            doCarry(cry->getAt(i+1), varmax->signBit(), varmin->signBit(), cry->getAt(i));
+        if(t->signBit()!=solver->False() && t->csize()<=len){
+            if(t->signBit()!=solver->True()) cols[t->csize()].emplace_back(-t->signBit());
+            constant -= Integer(1) << t->csize();
         }
-
-        // calculate sign bit of answer
-        doTarget(answer->signBit(), varmax->signBit(), varmin->signBit(), cry->getAt(size+1));
     }
-
+    // the constant modulo 2^(len+1)
+    Integer modulo = Integer(1) << (len+1);
+    constant %= modulo;
+    if(constant<0) constant += modulo;
+    for(size_t c=0;c<=len;c++){
+        if(mpz_tstbit(constant.get_mpz_t(), c)) cols[c].emplace_back(solver->True());
+    }
+    bvar answer = mkInnerVar(len, lo, hi);
+    sumColumns(cols, answer, mulMode!=WallaceMul);
     return answer;
 }
 bvar blaster_solver::MultiplyInt(bvar var, bvar v){
-    bvar subsum = mkInt(0);
-    for(size_t i=1;i<v->size();i++){
-        if(v->getAt(i)==1) subsum = Add(subsum, Shift(var, -(int)(i-1)));
+    scope s(this, OpMultiplyInt);
+    return MultiplyConst(var, v->getCurValue());
+}
+// var * v in non-adjacent form: an odd v is rest + d with d = +-1 and
+// 4 | rest, so a run of ones costs one subtraction, e.g. 15x = 16x - x.
+// the products are kept until reset, and the even ones are shifts of the
+// odd ones, so 3x is shared by 6x, 11x = 12x - x and 13x = 12x + x.
+bvar blaster_solver::MultiplyConst(bvar var, const Integer& v){
+    assert(v!=0);
+    if(v==1) return var;
+    // a folded sum may be constant, its bits are not literals
+    if(var->isConstant()) return mkInt(var->getCurValue() * v);
+    Integer odd = v;
+    unsigned len = compress(odd);
+    if(len>0) return Shift(MultiplyConst(var, odd), -(int)len);
+    std::pair<bvar, Integer> key(var, v);
+    std::map<std::pair<bvar, Integer>, bvar>::iterator it = ConstMap.find(key);
+    if(it!=ConstMap.end()) return it->second;
+    bvar ans = nullptr;
+    if(v==-1) ans = Negate(var);
+    else{
+        Integer r = v % 4;
+        if(r<0) r += 4;
+        if(r==1) ans = Add(MultiplyConst(var, v-1), var);
+        else ans = Subtract(MultiplyConst(var, v+1), var);
     }
-    return subsum;
+    ConstMap.insert(std::pair<std::pair<bvar, Integer>, bvar>(key, ans));
+    return ans;
 }
 bvar blaster_solver::MultiplyBit(bvar var, literal bit, unsigned len){
-    bvar answer = mkInnerVar("auxVar_submuli("+to_string(auxSize++)+")", len);
-    if(answer->size()<=var->size()){
-        for(size_t i=1;i<answer->size();i++){
-            // answer[i] == var[i] /\ bit
-
-            // ~answer[i] /\ var[i]
-            clause c;
-            c.emplace_back(-answer->getAt(i));
-            c.emplace_back(var->getAt(i));
-            addClause(c);
-            // ~answer[i] /\ bit
-            c.clear();
-            c.emplace_back(-answer->getAt(i));
-            c.emplace_back(bit);
-            addClause(c);
-            // answer[i] \/ ~bit \/ ~var[i]
-            c.clear();
-            c.emplace_back(answer->getAt(i));
-            c.emplace_back(-bit);
-            c.emplace_back(-var->getAt(i));
-            addClause(c);
-
-        }
-    }
-    else{ // answer->size() > var->size()
-        for(size_t i=1;i<var->size();i++){
-            // answer[i] == var[i] /\ bit
-            // ~answer[i] \/ var[i]
-            clause c;
-            c.emplace_back(-answer->getAt(i));
-            c.emplace_back(var->getAt(i));
-            addClause(c);
-            // ~answer[i] \/ bit
-            c.clear();
-            c.emplace_back(-answer->getAt(i));
-            c.emplace_back(bit);
-            addClause(c);
-            // answer[i] \/ ~bit \/ ~var[i]
-            c.clear();
-            c.emplace_back(answer->getAt(i));
-            c.emplace_back(-bit);
-            c.emplace_back(-var->getAt(i));
-            addClause(c);
-
-        }
-        // extend var's sign bit.
-        for(size_t i=var->size();i<answer->size();i++){
-            // answer[i] == var[0] /\ bit
-
-            // ~answer[i] \/ var[i]
-            clause c;
-            c.emplace_back(-answer->getAt(i));
-            c.emplace_back(var->signBit());
-            addClause(c);
-            // ~answer[i] \/ bit
-            c.clear();
-            c.emplace_back(-answer->getAt(i));
-            c.emplace_back(bit);
-            addClause(c);
-            // answer[i] \/ ~bit \/ ~var[i]
-            c.clear();
-            c.emplace_back(answer->getAt(i));
-            c.emplace_back(-bit);
-            c.emplace_back(-var->signBit());
-            addClause(c);
-        }
+    // a row of the array, only its bits are read.
+    // answer[i] == var[i] /\ bit, var extended with its sign bit, which is
+    // false for an unsigned var.
+    bvar answer = mkHolder(len);
+    answer->setAt(0, solver->False());
+    for(size_t i=1;i<answer->size();i++){
+        answer->setAt(i, AndGate(i<var->size()?var->getAt(i):var->signBit(), bit));
     }
     return answer;
 }
 bvar blaster_solver::MultiplyBitInt(bvar var, literal bit, unsigned len){
-    bvar answer = mkHolder("auxVar_submuli("+to_string(auxSize++)+")", len);
+    bvar answer = mkHolder(len);
     Escape(answer);
     if(answer->size()<=var->size()){
         for(size_t i=1;i<answer->size();i++){
@@ -468,64 +497,297 @@ bvar blaster_solver::MultiplyBitInt(bvar var, literal bit, unsigned len){
     return answer;
 }
 bvar blaster_solver::ShiftAdd(bvar subsum, bvar subans, bvar answer, unsigned idx){
-    // directly set subsum[1] == answer[index]
-    innerEqualBit(answer->getAt(idx-1), subsum->getAt(1));
+    // the lowest bit of the partial sum is final, answer takes its literal
+    answer->setAt(idx-1, subsum->getAt(1));
     unsigned size = answer->size()-idx;
-    bvar nextsubsum = mkInnerVar("auxVar_subsum("+to_string(auxSize++)+")", size);
-    bvar nextsubcry = mkInnerVar("auxVar_subcry("+to_string(auxSize++)+")", size);
-    size += 1; // nextsubsum->size(), debug: 2021.11.01
-    // nextsubcry[1] == false; nextsubcry[0], nextsubsum[0] is not important
-    clause c;
-    c.emplace_back(-nextsubcry->getAt(1));
-    addClause(c);
-    for(size_t i=1;i<size-1;i++){
-        doTarget(nextsubsum->getAt(i), subans->getAt(i), subsum->getAt(i+1), nextsubcry->getAt(i));
-        doCarry(nextsubcry->getAt(i+1), subans->getAt(i), subsum->getAt(i+1), nextsubcry->getAt(i));
-    }
-    doTarget(nextsubsum->getAt(size-1), subans->getAt(size-1), subsum->getAt(size), nextsubcry->getAt(size-1));
+    // only the bits of the partial sums are read, a ripple of gates from a
+    // false carry, so the false bits of the rows fold.
+    bvar nextsubsum = mkHolder(size);
+    nextsubsum->setAt(0, solver->False());
+    literal cry = solver->False();
+    for(size_t i=1;i<size;i++){
+        literal x = subans->getAt(i);
+        literal y = subsum->getAt(i+1);
+        nextsubsum->setAt(i, XorGate(x, y, cry));
+        cry = MajGate(x, y, cry);
+    }
+    nextsubsum->setAt(size, XorGate(subans->getAt(size), subsum->getAt(size+1), cry));
     return nextsubsum;
 }
+// compressor trees: the partial products are laid out by column, i.e. by
+// weight, and reduced by full and half adders until each column has at most
+// two bits, which a ripple adder sums into answer. the operands are sign
+// extended, and the carries out of the top column are dropped, as the array
+// does: answer keeps the product modulo 2^len and its sign bit is set by
+// Multiply.
+void blaster_solver::MultiplyTree(bvar varmax, bvar varmin, bvar answer, bool dadda){
+    size_t len = answer->csize();
+    std::vector<literals> cols(len);
+    for(size_t r=0;r<len;r++){
+        literal y = r+1<varmin->size()?varmin->getAt(r+1):varmin->signBit();
+        for(size_t c=r;c<len;c++){
+            literal x = c-r+1<varmax->size()?varmax->getAt(c-r+1):varmax->signBit();
+            literal pp = AndGate(x, y);
+            if(pp!=solver->False()) cols[c].emplace_back(pp);
+        }
+    }
+    sumColumns(cols, answer, dadda);
+}
+// reduces the columns of partial products and sums them into answer[1..],
+// a column past the magnitude bits goes to the sign bit.
+void blaster_solver::sumColumns(std::vector<literals>& cols, bvar answer, bool dadda){
+    size_t len = cols.size();
+    if(dadda){
+        // the heights of the stages: 2, 3, 4, 6, 9, 13, ...
+        size_t height = 0;
+        for(size_t c=0;c<len;c++) height = std::max(height, cols[c].size());
+        std::vector<size_t> heights(1, 2);
+        while(heights.back() < height) heights.emplace_back(heights.back() * 3 / 2);
+        for(size_t j=heights.size();j-->0;){
+            if(heights[j] < height) reduceDadda(cols, heights[j]);
+        }
+        // the carries into a column may leave it above the target
+        reduceDadda(cols, 2);
+    }
+    else reduceWallace(cols);
+
+    // final ripple adder
+    literal cry = solver->False();
+    for(size_t c=0;c<len;c++){
+        literal a = cols[c].size()>0?cols[c][0]:solver->False();
+        literal b = cols[c].size()>1?cols[c][1]:solver->False();
+        // an unsigned answer has no sign column
+        if(c+1>=answer->size() && answer->signBit()==solver->False()) break;
+        doTarget(c+1<answer->size()?answer->getAt(c+1):answer->signBit(), a, b, cry);
+        if(c+1<len){
+            literal next = findMaj(a, b, cry);
+            if(next==0){
+                next = newSatVar();
+                doCarry(next, a, b, cry);
+            }
+            cry = next;
+        }
+    }
+}
+// x*x with half of the partial products: x_i*x_j appears twice, i.e. once
+// in the next column, and x_i*x_i = x_i. with u the magnitude bits and s the
+// sign bit, x = u - s*2^n, so x^2 = u^2 - s*u*2^(n+1) mod 2^(2n), where the
+// subtrahend is negated as its inverted bits plus one.
+bvar blaster_solver::Square(bvar var){
+    scope s(this, OpSquare);
+    if(var->isConstant()) return mkInt(var->getCurValue() * var->getCurValue());
+    size_t n = var->csize();
+    Integer lo = lowerOf(var);
+    Integer hi = upperOf(var);
+    Integer sqhi = std::max(lo * lo, hi * hi);
+    Integer sqlo = (lo <= 0 && hi >= 0)?Integer(0):std::min(lo * lo, hi * hi);
+    // modulo 2^len, as the correction below is modulo 2^(2n)
+    size_t len = std::min(2 * n, (size_t)rangeWidth(sqlo, sqhi));
+    bvar answer = mkInnerVar(len, sqlo, sqhi); // unsigned
+    std::vector<literals> cols(len);
+    for(size_t i=0;i<n;i++){
+        literal xi = var->getAt(i+1);
+        if(xi!=solver->False() && 2*i<len) cols[2*i].emplace_back(xi);
+        for(size_t j=i+1;j<n && i+j+1<len;j++){
+            literal pp = AndGate(xi, var->getAt(j+1));
+            if(pp!=solver->False()) cols[i+j+1].emplace_back(pp);
+        }
+    }
+    literal sign = var->signBit();
+    if(sign!=solver->False()){
+        // -s*u*2^(n+1): the columns n+1.. get ~(s & u_k), and the one added
+        // to column n+1 folds with its bit t into t there and ~t above.
+        for(size_t c=n+1;c<len;c++){
+            literal t = AndGate(sign, var->getAt(c-n));
+            if(c==n+1){
+                if(t!=solver->False()) cols[c].emplace_back(t);
+                if(c+1<len && t!=solver->True()) cols[c+1].emplace_back(-t);
+            }
+            else if(t!=solver->True()) cols[c].emplace_back(-t);
+        }
+    }
+    sumColumns(cols, answer, mulMode!=WallaceMul);
+    return answer;
+}
+// x^k by repeated squaring, x^(2k) = (x^k)^2 and x^(k+1) = x^k * x, with
+// the powers of a variable kept until reset so x^2 is shared by x^3, x^4.
+bvar blaster_solver::Power(bvar var, unsigned k){
+    assert(k>0);
+    if(k==1) return var;
+    std::pair<bvar, unsigned> key(var, k);
+    boost::unordered_map<std::pair<bvar, unsigned>, bvar>::iterator it = PowMap.find(key);
+    if(it!=PowMap.end()) return it->second;
+    bvar ans = nullptr;
+    if(k%2==0) ans = Square(Power(var, k/2));
+    else ans = Multiply(Power(var, k-1), var);
+    PowMap.insert(std::pair<std::pair<bvar, unsigned>, bvar>(key, ans));
+    return ans;
+}
+// one stage of a wallace tree: every three bits of a column go to a full
+// adder and a remaining pair to a half adder.
+void blaster_solver::reduceWallace(std::vector<literals>& cols){
+    while(true){
+        size_t height = 0;
+        for(size_t c=0;c<cols.size();c++) height = std::max(height, cols[c].size());
+        if(height<=2) return;
+        std::vector<literals> next(cols.size());
+        for(size_t c=0;c<cols.size();c++) reduceColumn(cols, next, c, 0);
+        cols.swap(next);
+    }
+}
+// dadda stages: each column is brought down to the target height, counting
+// the carries it receives, with as few adders as possible.
+void blaster_solver::reduceDadda(std::vector<literals>& cols, size_t target){
+    while(true){
+        size_t height = 0;
+        for(size_t c=0;c<cols.size();c++) height = std::max(height, cols[c].size());
+        if(height<=target) return;
+        std::vector<literals> next(cols.size());
+        for(size_t c=0;c<cols.size();c++) reduceColumn(cols, next, c, target);
+        cols.swap(next);
+    }
+}
+// reduces column c into next, target 0 for as far as it goes.
+void blaster_solver::reduceColumn(std::vector<literals>& cols, std::vector<literals>& next, size_t c, size_t target){
+    literals& in = cols[c];
+    size_t k = 0;
+    // wallace leaves the columns that are low enough
+    if(target==0 && in.size()<=2){
+        next[c].insert(next[c].end(), in.begin(), in.end());
+        return;
+    }
+    // the carries of column c-1 are already in next[c]
+    size_t height = in.size() + next[c].size();
+    while(in.size()-k>=2 && height>target){
+        literal sum, cry;
+        if(in.size()-k==2 || (target>0 && height==target+1)){
+            HalfAdd(in[k], in[k+1], sum, cry);
+            k += 2;
+            height -= 1;
+        }
+        else{
+            FullAdd(in[k], in[k+1], in[k+2], sum, cry);
+            k += 3;
+            height -= 2;
+        }
+        next[c].emplace_back(sum);
+        if(c+1<cols.size()) next[c+1].emplace_back(cry);
+    }
+    for(;k<in.size();k++) next[c].emplace_back(in[k]);
+}
+literal blaster_solver::AndGate(literal a, literal b){
+    a = find(a); b = find(b);
+    if(a==solver->False() || b==solver->False()) return solver->False();
+    if(a==-solver->True() || b==-solver->True()) return solver->False();
+    if(a==solver->True() || a==-solver->False()) return b;
+    if(b==solver->True() || b==-solver->False()) return a;
+    if(a==b) return a;
+    if(a==-b) return solver->False();
+    literal in[2] = {a, b};
+    if(in[0]>in[1]) std::swap(in[0], in[1]);
+    literal g = findGate(GateAnd, in, 2);
+    if(g!=0) return g;
+    g = newSatVar();
+    doAnd(g, a, b);
+    return g;
+}
+// a xor b (xor c), the folded inputs make no gate.
+literal blaster_solver::XorGate(literal a, literal b, literal c){
+    literal in[3] = {find(a), find(b), c==0?0:find(c)};
+    bool parity = false;
+    unsigned n = foldXor(in, c==0?2:3, parity);
+    literal g = 0;
+    if(n==0) return parity?solver->True():solver->False();
+    else if(n==1) g = in[0];
+    else{
+        g = findXor(in[0], in[1], n==3?in[2]:0);
+        if(g!=0){
+            ++gatesHashed;
+            clausesSaved += n==3?8:4;
+        }
+        else{
+            g = newSatVar();
+            if(n==3) doTarget(g, in[0], in[1], in[2]);
+            else doTargetInt(g, in[0], 0, in[1]);
+        }
+    }
+    return parity?Not(g):g;
+}
+// majority, a known input leaves the and / or of the other two.
+literal blaster_solver::MajGate(literal a, literal b, literal c){
+    a = find(a); b = find(b); c = find(c);
+    literal in[3] = {a, b, c};
+    for(size_t i=0;i<3;i++){
+        int k = knownBit(in[i]);
+        if(k<0) continue;
+        literal x = in[(i+1)%3], y = in[(i+2)%3];
+        return k==1?Not(AndGate(Not(x), Not(y))):AndGate(x, y);
+    }
+    if(a==b || a==c) return a;
+    else if(b==c) return b;
+    else if(a==-b) return c;
+    else if(a==-c) return b;
+    else if(b==-c) return a;
+    literal g = findMaj(a, b, c);
+    if(g!=0){
+        ++gatesHashed;
+        clausesSaved += 7;
+        return g;
+    }
+    g = newSatVar();
+    doCarry(g, a, b, c);
+    return g;
+}
+void blaster_solver::FullAdd(literal a, literal b, literal c, literal& sum, literal& cry){
+    sum = XorGate(a, b, c);
+    cry = MajGate(a, b, c);
+}
+void blaster_solver::HalfAdd(literal a, literal b, literal& sum, literal& cry){
+    sum = XorGate(a, b);
+    cry = AndGate(a, b);
+}
+literal blaster_solver::bitOf(bvar var, size_t i){
+    literal b = i<var->size()?var->getAt(i):var->signBit();
+    if(var->isConstant()) return b==1?solver->True():solver->False();
+    return b;
+}
 bvar blaster_solver::Invert(bvar var){ return mkInvertedVar(var); }
 bvar blaster_solver::AddOne(bvar var){ return Add(var, mkInt(1), true); }
 bvar blaster_solver::Shift(bvar var, int len){
     // debug: 2021-11-06: len can not to unsigned.
-    if(len>(int)var->csize()) return mkInt(0);
-    else if(len==0) return var;
-    else return mkShiftedVar(var, len);
+    if(len==0) return var;
+    if(var->isConstant()) return mkInt(len>0?Integer(var->getCurValue() >> len):Integer(var->getCurValue() << -len)); // >> floors
+    if(len>(int)var->csize()) len = var->csize(); // 0 or -1, by the sign
+    return mkShiftedVar(var, len);
 }
 
 // inner auxiliary functions for math operations
 void blaster_solver::doCarry (literal cry1, literal varmax, literal varmin, literal cry0){
-    if(varmax == solver->False()){
-        doCarryInt(cry1, varmin, 0, cry0);
+    // a known input: and / or of the other two
+    literal ins[3] = {varmax, varmin, cry0};
+    for(size_t i=0;i<3;i++){
+        int k = knownBit(ins[i]);
+        if(k<0) continue;
+        doCarryInt(cry1, ins[(i+1)%3], k, ins[(i+2)%3]);
         return;
     }
-    else if(varmin == solver->False()){
-        doCarryInt(cry1, varmax, 0, cry0);
+    if(varmax==varmin){ // e.g. signbit in x + x<<1
+        // once varmax == varmin == 1, then cry1 == 1
+        // once varmax == varmin == 1, then cry1 will never == 1.
+        innerEqualBit(cry1, varmin);
         return;
     }
-    else if(cry0 == solver->False()){
-        doCarryInt(cry1, varmax, 0, varmin);
+    else if(varmax==cry0 || varmin==cry0){
+        innerEqualBit(cry1, cry0);
         return;
     }
-    else if(varmax==varmin){ // e.g. signbit in x + x<<1
-        clause c;
-        // once varmax == varmin == 1, then cry1 == 1
-        // once varmax == varmin == 1, then cry1 will never == 1.
-        // ~carry[i+1] \/ varmax[i] \/ varmin[i]
-        c.clear();
-        c.emplace_back(-cry1); 
-        c.emplace_back(varmin);
-        addClause(c);
-        // carry[i+1] \/ ~varmax[i] \/ ~varmin[i]
-        c.clear();
-        c.emplace_back(cry1); 
-        c.emplace_back(-varmin);
-        addClause(c);
-
+    else if(varmax==-varmin || varmax==-cry0 || varmin==-cry0){
+        // the pair cancels, the carry is the third one
+        innerEqualBit(cry1, varmax==-varmin?cry0:(varmax==-cry0?varmin:varmax));
         return;
     }
-    clause c;
+    if(hashedGate(cry1, findMaj(varmax, varmin, cry0), 7)) return;
+
     // carry -> ALL
     // ~carry[i+1] \/ varmax[i] \/ varmin[i] \/ carry[i]
     // c.clear();
@@ -535,257 +797,154 @@ void blaster_solver::doCarry (literal cry1, literal varmax, literal varmin, lite
     // c.emplace_back(cry0); 
     // addClause(c);
     // ~carry[i+1] \/ varmax[i] \/ varmin[i]
-    c.clear();
-    c.emplace_back(-cry1); 
-    c.emplace_back(varmax); 
-    c.emplace_back(varmin);
-    addClause(c);
+    addClause3(-cry1, varmax, varmin);
     // ~carry[i+1] \/ varmax[i] \/ carry[i]
-    c.clear();
-    c.emplace_back(-cry1); 
-    c.emplace_back(varmax);
-    c.emplace_back(cry0); 
-    addClause(c);
+    addClause3(-cry1, varmax, cry0);
     // ~carry[i+1] \/ varmin[i] \/ carry[i]
-    c.clear();
-    c.emplace_back(-cry1);
-    c.emplace_back(varmin); 
-    c.emplace_back(cry0); 
-    addClause(c);
+    addClause3(-cry1, varmin, cry0);
     
     // ALL -> carry
     // carry[i+1] \/ ~varmax[i] \/ ~varmin[i]
-    c.clear();
-    c.emplace_back(cry1); 
-    c.emplace_back(-varmax); 
-    c.emplace_back(-varmin);
-    addClause(c);
+    addClause3(cry1, -varmax, -varmin);
     // carry[i+1] \/ ~varmax[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(cry1); 
-    c.emplace_back(-varmax);
-    c.emplace_back(-cry0); 
-    addClause(c);
+    addClause3(cry1, -varmax, -cry0);
     // carry[i+1] \/ ~varmin[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(cry1);
-    c.emplace_back(-varmin); 
-    c.emplace_back(-cry0); 
-    addClause(c);
+    addClause3(cry1, -varmin, -cry0);
     // carry[i+1] \/ ~varmax[i] \/ ~varmin[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(cry1);
-    c.emplace_back(-varmax); 
-    c.emplace_back(-varmin); 
-    c.emplace_back(-cry0); 
-    addClause(c);
+    addClause4(cry1, -varmax, -varmin, -cry0);
+    literal in[3] = {varmax, varmin, cry0};
+    std::sort(in, in + 3);
+    keepGate(GateMaj, in, 3, cry1);
 }
 void blaster_solver::doTarget(literal target, literal varmax, literal varmin, literal cry){
-    if(varmax == solver->False()){
-        doTargetInt(target, varmin, 0, cry);
+    // known inputs and pairs, e.g. signbit in x + x<<1
+    literal in[3] = {varmax, varmin, cry};
+    bool parity = false;
+    unsigned n = foldXor(in, 3, parity);
+    if(n==0){
+        addClause1(parity?target:-target);
         return;
     }
-    else if(varmin == solver->False()){
-        doTargetInt(target, varmax, 0, cry);
+    else if(n==1){
+        innerEqualBit(target, parity?-in[0]:in[0]);
         return;
     }
-    else if(cry == solver->False()){
-        doTargetInt(target, varmax, 0, varmin);
-        return;
-    }
-    else if(varmax==varmin){ // signbit in x + x<<1
-        clause c;
-        // ~target[i] \/ varmax[i] \/ varmin[i] \/ carry[i]
-        c.clear();
-        c.emplace_back(-target); 
-        c.emplace_back(varmax); 
-        c.emplace_back(cry); 
-        addClause(c);
-        // ~target[i] \/ ~varmax[i] \/ ~varmin[i] \/ carry[i]
-        c.clear();
-        c.emplace_back(-target); 
-        c.emplace_back(-varmax); 
-        c.emplace_back(cry); 
-        addClause(c);
-        // target[i] \/ varmax[i] \/ varmin[i] \/ ~carry[i]
-        c.clear();
-        c.emplace_back(target); 
-        c.emplace_back(varmax); 
-        c.emplace_back(-cry); 
-        addClause(c);
-        // target[i] \/ ~varmax[i] \/ ~varmin[i] \/ ~carry[i]
-        c.clear();
-        c.emplace_back(target); 
-        c.emplace_back(-varmax); 
-        c.emplace_back(-cry); 
-        addClause(c);
-
+    else if(n==2){
+        doTargetInt(target, in[0], parity?1:0, in[1]);
         return;
     }
     // target <-> varmax xor varmin xor cry
-    clause c;
+    if(hashedGate(target, findXor(varmax, varmin, cry), 8)) return;
     // target -> ALL
     // ~target[i] \/ varmax[i] \/ varmin[i] \/ carry[i]
-    c.clear();
-    c.emplace_back(-target); 
-    c.emplace_back(varmax); 
-    c.emplace_back(varmin); 
-    c.emplace_back(cry); 
-    addClause(c);
+    addClause4(-target, varmax, varmin, cry);
     // ~target[i] \/ varmax[i] \/ ~varmin[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(-target); 
-    c.emplace_back(varmax); 
-    c.emplace_back(-varmin); 
-    c.emplace_back(-cry); 
-    addClause(c);
+    addClause4(-target, varmax, -varmin, -cry);
     // ~target[i] \/ ~varmax[i] \/ varmin[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(-target); 
-    c.emplace_back(-varmax); 
-    c.emplace_back(varmin); 
-    c.emplace_back(-cry); 
-    addClause(c);
+    addClause4(-target, -varmax, varmin, -cry);
     // ~target[i] \/ ~varmax[i] \/ ~varmin[i] \/ carry[i]
-    c.clear();
-    c.emplace_back(-target); 
-    c.emplace_back(-varmax); 
-    c.emplace_back(-varmin); 
-    c.emplace_back(cry); 
-    addClause(c);
+    addClause4(-target, -varmax, -varmin, cry);
     
     // ALL -> target
     // target[i] \/ varmax[i] \/ varmin[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(target); 
-    c.emplace_back(varmax); 
-    c.emplace_back(varmin); 
-    c.emplace_back(-cry); 
-    addClause(c);
+    addClause4(target, varmax, varmin, -cry);
     // target[i] \/ varmax[i] \/ ~varmin[i] \/ carry[i]
-    c.clear();
-    c.emplace_back(target); 
-    c.emplace_back(varmax); 
-    c.emplace_back(-varmin); 
-    c.emplace_back(cry); 
-    addClause(c);
+    addClause4(target, varmax, -varmin, cry);
     // target[i] \/ ~varmax[i] \/ varmin[i] \/ carry[i]
-    c.clear();
-    c.emplace_back(target); 
-    c.emplace_back(-varmax); 
-    c.emplace_back(varmin); 
-    c.emplace_back(cry); 
-    addClause(c);
+    addClause4(target, -varmax, varmin, cry);
     // target[i] \/ ~varmax[i] \/ ~varmin[i] \/ ~carry[i]
-    c.clear();
-    c.emplace_back(target); 
-    c.emplace_back(-varmax); 
-    c.emplace_back(-varmin); 
-    c.emplace_back(-cry); 
-    addClause(c);
+    addClause4(target, -varmax, -varmin, -cry);
+    keepXor(target, varmax, varmin, cry);
+}
+void blaster_solver::doAnd(literal target, literal var1, literal var2){
+    literal in[2] = {var1, var2};
+    if(in[0]>in[1]) std::swap(in[0], in[1]);
+    if(hashedGate(target, findGate(GateAnd, in, 2), 3)) return;
+    keepGate(GateAnd, in, 2, target);
+    // ~target \/ var1
+    addClause2(-target, var1);
+    // ~target \/ var2
+    addClause2(-target, var2);
+    // target \/ ~var1 \/ ~var2
+    addClause3(target, -var1, -var2);
 }
 void blaster_solver::doCarryInt (literal cry1, literal var, literal ivar, literal cry0){
-    clause c;
+    // and (ivar 0) / or (ivar 1) with a known or a repeated input
+    int k = knownBit(var)>=0?knownBit(var):knownBit(cry0);
+    if(k>=0 || var==cry0 || var==-cry0){
+        if(var==cry0) innerEqualBit(cry1, var);
+        else if(var==-cry0 || k==ivar) addClause1(ivar==1?cry1:-cry1);
+        else innerEqualBit(cry1, knownBit(var)>=0?cry0:var);
+        return;
+    }
+    // var /\ cry0, or var \/ cry0 == ~(~var /\ ~cry0)
+    literal in[2] = {ivar==0?var:-var, ivar==0?cry0:-cry0};
+    if(in[0]>in[1]) std::swap(in[0], in[1]);
+    literal g = findGate(GateAnd, in, 2);
+    if(g!=0 && hashedGate(cry1, ivar==0?g:-g, 5)) return;
+    keepGate(GateAnd, in, 2, ivar==0?cry1:-cry1);
     if(ivar==0){
         // ~cry1 \/ var
-        c.clear();
-        c.emplace_back(-cry1); 
-        c.emplace_back(var);
-        addClause(c);
+        addClause2(-cry1, var);
 
         // ~cry1 \/ cry0
-        c.clear();
-        c.emplace_back(-cry1);
-        c.emplace_back(cry0); 
-        addClause(c);
+        addClause2(-cry1, cry0);
 
         // cry1 \/ ~var \/ ~cry0
-        c.clear();
-        c.emplace_back(cry1); 
-        c.emplace_back(-var);
-        c.emplace_back(-cry0); 
-        addClause(c);
+        addClause3(cry1, -var, -cry0);
     }
     else{ // ivar = 1
         // ~cry1 \/ var \/ cry0
-        c.clear();
-        c.emplace_back(-cry1); 
-        c.emplace_back(var);
-        c.emplace_back(cry0); 
-        addClause(c);
+        addClause3(-cry1, var, cry0);
         
         // cry1 \/ ~var
-        c.clear();
-        c.emplace_back(cry1); 
-        c.emplace_back(-var);
-        addClause(c);
+        addClause2(cry1, -var);
 
         // cry1 \/ ~cry0
-        c.clear();
-        c.emplace_back(cry1);
-        c.emplace_back(-cry0); 
-        addClause(c);
+        addClause2(cry1, -cry0);
     }
 }
 void blaster_solver::doTargetInt(literal target, literal var, literal ivar, literal cry){
-    clause c;
+    // target == var xor cry xor ivar
+    literal in[2] = {var, cry};
+    bool parity = ivar==1;
+    unsigned n = foldXor(in, 2, parity);
+    if(n==0){
+        addClause1(parity?target:-target);
+        return;
+    }
+    else if(n==1){
+        innerEqualBit(target, parity?-in[0]:in[0]);
+        return;
+    }
+    literal g = findXor(var, cry);
+    if(g!=0 && hashedGate(target, ivar==1?-g:g, 6)) return;
+    keepXor(ivar==1?-target:target, var, cry);
     if(ivar==1){ 
         // ~target \/ var \/ ~cry
-        c.clear();
-        c.emplace_back(-target); 
-        c.emplace_back(var);
-        c.emplace_back(-cry); 
-        addClause(c);
+        addClause3(-target, var, -cry);
 
         // ~target \/ ~var \/ cry
-        c.clear();
-        c.emplace_back(-target); 
-        c.emplace_back(-var);
-        c.emplace_back(cry); 
-        addClause(c);
+        addClause3(-target, -var, cry);
 
         // target \/ ~var \/ ~cry
-        c.clear();
-        c.emplace_back(target); 
-        c.emplace_back(-var); 
-        c.emplace_back(-cry); 
-        addClause(c);
+        addClause3(target, -var, -cry);
 
         // target \/ var \/ cry
-        c.clear();
-        c.emplace_back(target); 
-        c.emplace_back(var);
-        c.emplace_back(cry); 
-        addClause(c);
+        addClause3(target, var, cry);
     }
     else{ // ivar = 0
         // ~target \/ ~var \/ ~cry
-        c.clear();
-        c.emplace_back(-target); 
-        c.emplace_back(-var); 
-        c.emplace_back(-cry); 
-        addClause(c);
+        addClause3(-target, -var, -cry);
 
         // ~target \/ var \/ cry
-        c.clear();
-        c.emplace_back(-target); 
-        c.emplace_back(var);
-        c.emplace_back(cry); 
-        addClause(c);
+        addClause3(-target, var, cry);
 
         // target \/ ~var \/ cry
-        c.clear();
-        c.emplace_back(target); 
-        c.emplace_back(-var);
-        c.emplace_back(cry); 
-        addClause(c);
+        addClause3(target, -var, cry);
         
         // target \/ var \/ ~cry
-        c.clear();
-        c.emplace_back(target); 
-        c.emplace_back(var);
-        c.emplace_back(-cry); 
-        addClause(c);
+        addClause3(target, var, -cry);
     }
 }
 
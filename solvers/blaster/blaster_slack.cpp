@@ -11,26 +11,33 @@ using namespace ismt;
 
 
 // Slack Abstraction: e.g. a > b <=> a == b + t /\ t > 0.
+// the slack holds any difference of the two, in either direction, or the
+// sum would overflow and the atom be false when it holds.
+bvar blaster_solver::mkSlack(bvar var1, bvar var2){
+    Integer up = upperOf(var1) - lowerOf(var2), down = upperOf(var2) - lowerOf(var1);
+    Integer hi = up > down? up: down;
+    return mkInnerVar(rangeWidth(-hi, hi));
+}
 literal blaster_solver::SEqual(bvar var1, bvar var2){ // var1 == var2
-    bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+    bvar slack = mkSlack(var1, var2);
     bvar ans = Add(slack, var1);
     innerEqualVar(var2, ans);
     return EqZero(slack);
 }
 literal blaster_solver::SNotEqual(bvar var1, bvar var2){ // var1 != var2
-    bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+    bvar slack = mkSlack(var1, var2);
     bvar ans = Add(slack, var1);
     innerEqualVar(var2, ans);
     return NeqZero(slack);
 }
 literal blaster_solver::SGreater(bvar var1, bvar var2){ // var1 > var2
-    bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+    bvar slack = mkSlack(var1, var2);
     bvar ans = Add(slack, var2);
     innerEqualVar(var1, ans);
     return GtZero(slack);
 }
 literal blaster_solver::SGreaterEqual(bvar var1, bvar var2){ // var1 >= var2
-    bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+    bvar slack = mkSlack(var1, var2);
     bvar ans = Add(slack, var2);
     innerEqualVar(var1, ans);
     return GeZero(slack);
@@ -42,7 +49,7 @@ literal blaster_solver::SEqualInt(bvar var1, bvar var2){
     if(v->getCurValue()==0){
         return EqZero(var);
     }
-    bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var->csize(), v->csize()));
+    bvar slack = mkSlack(var, v);
     if(add2i){
         bvar ans = Add(slack, v);
         innerEqualVar(var, ans);
@@ -61,7 +68,7 @@ literal blaster_solver::SNotEqualInt(bvar var1, bvar var2){
     if(v->getCurValue()==0){
         return NeqZero(var);
     }
-    bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var->csize(), v->csize()));
+    bvar slack = mkSlack(var, v);
     if(add2i){
         bvar ans = Add(slack, v);
         innerEqualVar(var, ans);
@@ -80,7 +87,7 @@ literal blaster_solver::SGreaterInt(bvar var1, bvar var2){ // var1 > var2
             return LtZero(var2);
         }
         else{
-            bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+            bvar slack = mkSlack(var1, var2);
             if(add2i){
                 bvar ans = Add(slack, var1);
                 innerEqualVar(var2, ans);
@@ -100,7 +107,7 @@ literal blaster_solver::SGreaterInt(bvar var1, bvar var2){ // var1 > var2
             return GtZero(var1);
         }
         else{
-            bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+            bvar slack = mkSlack(var1, var2);
             if(add2i){
                 bvar ans = Add(slack, var2);
                 innerEqualVar(var1, ans);
@@ -123,7 +130,7 @@ literal blaster_solver::SGreaterEqualInt(bvar var1, bvar var2){ // var1 >= var2
             return LeZero(var2);
         }
         else{
-            bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+            bvar slack = mkSlack(var1, var2);
             if(add2i){
                 bvar ans = Add(slack, var1);
                 innerEqualVar(var2, ans);
@@ -144,7 +151,7 @@ literal blaster_solver::SGreaterEqualInt(bvar var1, bvar var2){ // var1 >= var2
             return GeZero(var1);
         }
         else{
-            bvar slack = mkInnerVar("slack_"+to_string(slackSize++), max(var1->csize(), var2->csize()));
+            bvar slack = mkSlack(var1, var2);
             if(add2i){
                 bvar ans = Add(slack, var2);
                 innerEqualVar(var1, ans);
@@ -162,96 +169,122 @@ literal blaster_solver::SGreaterEqualInt(bvar var1, bvar var2){ // var1 >= var2
 }
 
 // auxiliary functions
-literal blaster_solver::GtZero(bvar var){
-    assert(!var->isConstant());
-    // t <-> \/ var[i] /\ ~var[0]
-    bool_var t = newSatVar();
-    // t -> \/ var[i], i>=1 
-    clause c;
-    c.emplace_back(-t);
+literal blaster_solver::GtZero(bvar var, Polarity pol){
+    // a constant, e.g. the difference of equal terms
+    if(var->isConstant()) return var->getCurValue()>0?solver->True():solver->False();
+    // known bits: a true sign, or a true bit of a var that is not negative
+    if(knownBit(var->signBit())==1) return solver->False();
+    bool free = false;
     for(size_t i=1;i<var->size();i++){
-        c.emplace_back(var->getAt(i));
+        int k = knownBit(var->getAt(i));
+        if(k==1) return Not(var->signBit());
+        else if(k<0) free = true;
     }
-    addClause(c);
+    if(!free) return solver->False();
+    // t <-> \/ var[i] /\ ~var[0]
+    bool_var t = newSatVar();
+    if(pol & PolPos){
+        // t -> \/ var[i], i>=1 
+        clause c;
+        c.emplace_back(-t);
+        for(size_t i=1;i<var->size();i++){
+            c.emplace_back(var->getAt(i));
+        }
+        addClause(c);
 
-    // t -> ~var[0]
-    c.clear();
-    c.emplace_back(-t);
-    c.emplace_back(-var->signBit());
-    addClause(c);
+        // t -> ~var[0]
+        addClause2(-t, -var->signBit());
+    }
 
-    // var[0] \/ ~var[i] \/ tmp, i>=1
-    for(size_t i=1;i<var->size();i++){
-        c.clear();
-        c.emplace_back(t);
-        c.emplace_back(var->signBit());
-        c.emplace_back(-var->getAt(i));
-        addClause(c);
+    if(pol & PolNeg){
+        // var[0] \/ ~var[i] \/ tmp, i>=1
+        for(size_t i=1;i<var->size();i++){
+            addClause3(t, var->signBit(), -var->getAt(i));
+        }
     }
 
     return t;
 }
 literal blaster_solver::GeZero(bvar var){
-    assert(!var->isConstant());
+    if(var->isConstant()) return var->getCurValue()>=0?solver->True():solver->False();
     // sign bit = 0 
     return -var->signBit();
 }
 literal blaster_solver::LtZero(bvar var){
-    assert(!var->isConstant());
+    if(var->isConstant()) return var->getCurValue()<0?solver->True():solver->False();
     // sign bit = 1 and Escape.
     return var->signBit();
 }
-literal blaster_solver::LeZero(bvar var){
-    assert(!var->isConstant());
+literal blaster_solver::LeZero(bvar var, Polarity pol){
+    if(var->isConstant()) return var->getCurValue()<=0?solver->True():solver->False();
     // var < 0 \/ var == 0
     literals lits;
     lits.emplace_back(LtZero(var));
-    lits.emplace_back(EqZero(var));
-    return Or(lits);
+    lits.emplace_back(EqZero(var, pol));
+    return Or(lits, pol);
 }
-literal blaster_solver::EqZero(bvar var){
-    assert(!var->isConstant());
+literal blaster_solver::EqZero(bvar var, Polarity pol){
+    if(var->isConstant()) return var->getCurValue()==0?solver->True():solver->False();
     if(EqZeroMap.find(var)!=EqZeroMap.end()) return EqZeroMap[var];
+    // known bits: a true one, or only false ones
+    bool free = false;
+    for(size_t i=0;i<var->size();i++){
+        int k = knownBit(var->getAt(i));
+        if(k==1) return solver->False();
+        else if(k<0) free = true;
+    }
+    if(!free) return solver->True();
     // t <-> /\ ~var[i].
     bool_var t =  newSatVar();
     // t -> /\ ~var[i] <=> ~t \/ ~var[i], i>=0
-    for(size_t i=0;i<var->size();i++){
-        clause c;
-        c.emplace_back(-t);
-        c.emplace_back(-var->getAt(i));
-        addClause(c);
+    if(pol & PolPos){
+        for(size_t i=0;i<var->size();i++){
+            addClause2(-t, -var->getAt(i));
+        }
     }
 
     // /\ ~var[i] -> t <=> \/ var[i] \/ t, i>=0
-    clause c;
-    c.emplace_back(t);
-    for(size_t i=0;i<var->size();i++){
-        c.emplace_back(var->getAt(i));
+    if(pol & PolNeg){
+        clause c;
+        c.emplace_back(t);
+        for(size_t i=0;i<var->size();i++){
+            c.emplace_back(var->getAt(i));
+        }
+        addClause(c);
     }
-    addClause(c);
 
-    EqZeroMap.insert(std::pair<bvar, bool_var>(var, t));
+    // only the full test is shared.
+    if(pol==PolBoth) EqZeroMap.insert(std::pair<bvar, bool_var>(var, t));
 
     return t;
 }
-literal blaster_solver::NeqZero(bvar var){
-    assert(!var->isConstant());
+literal blaster_solver::NeqZero(bvar var, Polarity pol){
+    if(var->isConstant()) return var->getCurValue()!=0?solver->True():solver->False();
+    // known bits: a true one, or only false ones
+    bool free = false;
+    for(size_t i=1;i<var->size();i++){
+        int k = knownBit(var->getAt(i));
+        if(k==1) return solver->True();
+        else if(k<0) free = true;
+    }
+    if(!free) return solver->False();
     // t <-> \/ var[i].
     bool_var t =  newSatVar();
     // t -> \/ var[i] <=> ~t \/ (\/ var[i]), i>=1
-    clause c;
-    c.emplace_back(-t);
-    for(size_t i=1;i<var->size();i++){
-        c.emplace_back(var->getAt(i));
+    if(pol & PolPos){
+        clause c;
+        c.emplace_back(-t);
+        for(size_t i=1;i<var->size();i++){
+            c.emplace_back(var->getAt(i));
+        }
+        addClause(c);
     }
-    addClause(c);
 
     // \/ var[i] -> t <=>  ~var[i] \/ t, i>=1
-    for(size_t i=1;i<var->size();i++){
-        c.clear();
-        c.emplace_back(t);
-        c.emplace_back(-var->getAt(i));
-        addClause(c);
+    if(pol & PolNeg){
+        for(size_t i=1;i<var->size();i++){
+            addClause2(t, -var->getAt(i));
+        }
     }
 
     return t;
@@ -8,6 +8,7 @@
 #include "solvers/blaster/blaster_solver.hpp"
 
 #include <iostream>
+#include <boost/unordered_set.hpp>
 
 using namespace ismt;
 
@@ -17,8 +18,6 @@ using namespace ismt;
 blaster_solver::blaster_solver(std::string n){
     solver = new sat_solver(n);
     default_len = 10;
-    auxSize = 0;
-    slackSize = 0;
 
     setvvEqMode(Recursion);
     setvvCompMode(Transposition);
@@ -32,6 +31,15 @@ blaster_solver::~blaster_solver(){
 }
 void blaster_solver::reset(){
     clearVars();
+    PoolUsed = 0;
+    GateMap.clear();
+    GateSides.clear();
+    Rep.clear();
+    Used.clear();
+    PowMap.clear();
+    ConstMap.clear();
+    DiffMap.clear();
+    DivMap.clear();
     solver->reset();
 }
 void blaster_solver::clearVars(){
@@ -76,23 +84,94 @@ void blaster_solver::outputError(const std::string& mesg){
 
 // ------------add clause------------
 void blaster_solver::addClause(clause& c){
-    clause copy_lits(c);std::sort(copy_lits.begin(), copy_lits.end());
-    clause ans;
-    for(size_t i=0;i<copy_lits.size();i++){
-        if(copy_lits[i]==solver->True()) return;
-        if(copy_lits[i]==-solver->False()) return;
-        else if(copy_lits[i]==solver->False()) continue;
-        else if(copy_lits[i]==-solver->True()) continue;
-        else if(i!=0&&copy_lits[i]==copy_lits[i-1]) continue;
-        else ans.emplace_back(copy_lits[i]);
+    buffer.resize(c.size());
+    for(size_t i=0;i<c.size();i++) buffer[i] = find(c[i]);
+    std::sort(buffer.begin(), buffer.end());
+    size_t n = 0;
+    for(size_t i=0;i<buffer.size();i++){
+        if(buffer[i]==solver->True()) return;
+        if(buffer[i]==-solver->False()) return;
+        else if(buffer[i]==solver->False()) continue;
+        else if(buffer[i]==-solver->True()) continue;
+        else if(i!=0&&buffer[i]==buffer[i-1]) continue;
+        else buffer[n++] = buffer[i];
     }
-    solver->addClause(ans);
+    for(size_t i=0;i<n;i++) markUsed(buffer[i]);
+    solver->addClause(buffer.data(), n);
+}
+// drops the false constants and the duplicates in place,
+// and the whole clause once it has a true constant.
+void blaster_solver::emitClause(literal* lits, unsigned n){
+    unsigned k = 0;
+    for(unsigned i=0;i<n;i++){
+        literal l = find(lits[i]);
+        if(l==solver->True() || l==-solver->False()) return;
+        if(l==solver->False() || l==-solver->True()) continue;
+        bool dup = false;
+        for(unsigned j=0;j<k;j++){
+            if(lits[j]==l){ dup = true; break; }
+        }
+        if(!dup) lits[k++] = l;
+    }
+    for(unsigned i=0;i<k;i++) markUsed(lits[i]);
+    solver->addClause(lits, k);
+}
+
+// ------------literal equivalence------------
+literal blaster_solver::find(literal l){
+    size_t v = abs(l);
+    if(v >= Rep.size() || Rep[v] == 0) return l;
+    literal r = find(Rep[v]);
+    Rep[v] = r;
+    return l>0?r:-r;
+}
+void blaster_solver::markUsed(literal l){
+    size_t v = abs(l);
+    if(v >= Used.size()) Used.resize(2 * v + 1, false);
+    Used[v] = true;
+}
+// binds the free one of a and b to the other, the constants and the
+// variables in a clause are never free.
+bool blaster_solver::merge(literal a, literal b){
+    a = find(a);
+    b = find(b);
+    if(a == b) return true;
+    if(a == -b) return false;
+    for(int i=0;i<2;i++){
+        size_t v = abs(a);
+        bool fixed = v == 0 || a == solver->True() || a == -solver->True() ||
+                     a == solver->False() || a == -solver->False();
+        if(!fixed && (v >= Used.size() || !Used[v])){
+            if(v >= Rep.size()) Rep.resize(2 * v + 1, 0);
+            Rep[v] = a>0?b:-b;
+            ++litsMerged;
+            return true;
+        }
+        std::swap(a, b);
+    }
+    return false;
+}
+void blaster_solver::addClause1(literal a){
+    emitClause(&a, 1);
+}
+void blaster_solver::addClause2(literal a, literal b){
+    literal lits[2] = {a, b};
+    emitClause(lits, 2);
+}
+void blaster_solver::addClause3(literal a, literal b, literal c){
+    literal lits[3] = {a, b, c};
+    emitClause(lits, 3);
+}
+void blaster_solver::addClause4(literal a, literal b, literal c, literal d){
+    literal lits[4] = {a, b, c, d};
+    emitClause(lits, 4);
 }
 
 // ------------solve operations------------
 int blaster_solver::Assert(literal lit){
-    literals lits { lit };
-    solver->addClause(lits);
+    lit = find(lit);
+    markUsed(lit);
+    solver->addClause(&lit, 1);
     return 1;
 }
 bool blaster_solver::solve(){
@@ -102,10 +181,27 @@ bool blaster_solver::solve(){
 }
 bool blaster_solver::solve(const literals& assumptions){
     if(assumptions.size() == 0) return true;
-    solver->solve(assumptions);
+    literals as(assumptions);
+    for(size_t i=0;i<as.size();i++){
+        as[i] = find(as[i]);
+        markUsed(as[i]);
+    }
+    if(solver->cubing()){
+        literals lits;
+        splits(lits);
+        solver->solve(as, lits);
+    }
+    else solver->solve(as);
     if(State::SAT==solver->getState()) getModel();
     return State::SAT==solver->getState();
 }
+bool blaster_solver::unsat() const{
+    return State::UNSAT==solver->getState();
+}
+void blaster_solver::getConflict(literals& assumptions){
+    if(State::UNSAT!=solver->getState()) return;
+    solver->getConflict(assumptions);
+}
 bool blaster_solver::simplify(){
     literals c;
     return simplify(c);
@@ -116,29 +212,33 @@ bool blaster_solver::simplify(const literals& assumptions){
     return State::UNSAT!=solver->getState();
 }
 
+// a bit may be a negated literal, e.g. of a copied sum
+bool blaster_solver::valueOf(literal l) const{
+    return l>0?mdl[l]!=0:mdl[-l]==0;
+}
 // calculate value from bit-blasting
 Integer blaster_solver::calculate(bvar var){
-    int sign = mdl[abs(var->signBit())]?-1:1;
+    int sign = valueOf(var->signBit())?-1:1;
     #if modelDebug
-        std::cout<<var->getName()<<": 0x"<<mdl[abs(var->signBit())];
+        std::cout<<var->getName()<<": 0x"<<valueOf(var->signBit());
     #endif
     Integer answer = 0;
     if(sign==-1){
         for(int i=var->size()-1;i>0;i--){
-            answer = answer*2 + (mdl[abs(var->getAt(i))]?0:1);
+            answer = answer*2 + (valueOf(var->getAt(i))?0:1);
 
             #if modelDebug
-                std::cout<<(mdl[abs(var->getAt(i))]?0:1);
+                std::cout<<(valueOf(var->getAt(i))?0:1);
             #endif
         }
         answer += 1;
     }
     else{
         for(int i=var->size()-1;i>0;i--){
-            answer = answer*2 + (mdl[abs(var->getAt(i))]?1:0);
+            answer = answer*2 + (valueOf(var->getAt(i))?1:0);
             
             #if modelDebug
-                std::cout<<(mdl[abs(var->getAt(i))]?1:0);
+                std::cout<<(valueOf(var->getAt(i))?1:0);
             #endif
         }
     }
@@ -153,6 +253,12 @@ Integer blaster_solver::calculate(bvar var){
 void blaster_solver::getModel(){
     assert(State::SAT==solver->getState());
     mdl = solver->getModel();
+    // a merged variable takes the value of its representative
+    for(size_t v=1;v<Rep.size() && v<mdl.size();v++){
+        if(Rep[v] == 0) continue;
+        literal r = find(v);
+        mdl[v] = r>0?mdl[r]:!mdl[-r];
+    }
     for(size_t i=0;i<ProblemVars.size();i++){
         if(!ProblemVars[i]->isConstant()){
             ProblemVars[i]->setCurValue(calculate(ProblemVars[i]));
@@ -198,50 +304,127 @@ Integer blaster_solver::getValue(const std::string& name){
 // ------------set operations------------
 void blaster_solver::setDeaultLen(unsigned len){ default_len = len; }
 
-literal blaster_solver::vvEq(bvar var1, bvar var2){
-    if(vvEqMode==Slack) return SEqual(var1, var2);
-    else if(vvEqMode==Recursion) return REqual(var1, var2);
-    else return TEqual(var1, var2);
+literal blaster_solver::vvEq(bvar var1, bvar var2, Polarity pol){
+    ConstraintsMode m = eqMode(false);
+    scope s(this, (OpKind)(OpEqSlack + m));
+    if(m==Slack) return SEqual(var1, var2);
+    else if(m==Recursion) return REqual(var1, var2, pol);
+    else return TEqual(var1, var2, pol);
 }
-literal blaster_solver::vvGt(bvar var1, bvar var2){
-    if(vvCompMode==Slack) return SGreater(var1, var2);
-    else if(vvCompMode==Recursion) return RGreater(var1, var2);
-    else return TGreater(var1, var2);
+literal blaster_solver::vvGt(bvar var1, bvar var2, Polarity pol){
+    ConstraintsMode m = compMode(false);
+    scope s(this, (OpKind)(OpCompSlack + m));
+    if(m==Slack) return SGreater(var1, var2);
+    else if(m==Recursion) return RGreater(var1, var2);
+    else return TGreater(var1, var2, pol);
 }
 literal blaster_solver::vvGe(bvar var1, bvar var2){
-    if(vvCompMode==Slack) return SGreaterEqual(var1, var2);
-    else if(vvCompMode==Recursion) return RGreaterEqual(var1, var2);
+    ConstraintsMode m = compMode(false);
+    scope s(this, (OpKind)(OpCompSlack + m));
+    if(m==Slack) return SGreaterEqual(var1, var2);
+    else if(m==Recursion) return RGreaterEqual(var1, var2);
     else return TGreaterEqual(var1, var2);
 }
-literal blaster_solver::vvNeq(bvar var1, bvar var2){
-    if(vvEqMode==Slack) return SNotEqual(var1, var2);
-    else if(vvEqMode==Recursion) return RNotEqual(var1, var2);
-    else return TNotEqual(var1, var2);
+literal blaster_solver::vvNeq(bvar var1, bvar var2, Polarity pol){
+    ConstraintsMode m = eqMode(false);
+    scope s(this, (OpKind)(OpEqSlack + m));
+    if(m==Slack) return SNotEqual(var1, var2);
+    else if(m==Recursion) return RNotEqual(var1, var2, pol);
+    else return TNotEqual(var1, var2, pol);
 }
-literal blaster_solver::viEq(bvar var, bvar v){
-    if(viEqMode==Slack) return SEqualInt(var, v);
-    else if(viEqMode==Recursion) return REqualInt(var, v);
-    else return TEqualInt(var, v);
+literal blaster_solver::viEq(bvar var, bvar v, Polarity pol){
+    ConstraintsMode m = eqMode(true);
+    scope s(this, (OpKind)(OpEqSlack + m));
+    if(m==Slack) return SEqualInt(var, v);
+    else if(m==Recursion) return REqualInt(var, v, pol);
+    else return TEqualInt(var, v, pol);
 }
-literal blaster_solver::viGt(bvar var, bvar v){
-    if(viCompMode==Slack) return SGreaterInt(var, v);
-    else if(viCompMode==Recursion) return RGreaterInt(var, v);
-    else return TGreaterInt(var, v);
+literal blaster_solver::viGt(bvar var, bvar v, Polarity pol){
+    ConstraintsMode m = compMode(true);
+    scope s(this, (OpKind)(OpCompSlack + m));
+    if(m==Slack) return SGreaterInt(var, v);
+    else if(m==Recursion) return RGreaterInt(var, v);
+    else return TGreaterInt(var, v, pol);
 }
-literal blaster_solver::viGe(bvar var, bvar v){
-    if(viCompMode==Slack) return SGreaterEqualInt(var, v);
-    else if(viCompMode==Recursion) return RGreaterEqualInt(var, v);
-    else return TGreaterEqualInt(var, v);
+literal blaster_solver::viGe(bvar var, bvar v, Polarity pol){
+    ConstraintsMode m = compMode(true);
+    scope s(this, (OpKind)(OpCompSlack + m));
+    if(m==Slack) return SGreaterEqualInt(var, v);
+    else if(m==Recursion) return RGreaterEqualInt(var, v);
+    else return TGreaterEqualInt(var, v, pol);
 }
-literal blaster_solver::viNeq(bvar var, bvar v){
-    if(viEqMode==Slack) return SNotEqualInt(var, v);
-    else if(viEqMode==Recursion) return RNotEqualInt(var, v);
-    else return TNotEqualInt(var, v);
+literal blaster_solver::viNeq(bvar var, bvar v, Polarity pol){
+    ConstraintsMode m = eqMode(true);
+    scope s(this, (OpKind)(OpEqSlack + m));
+    if(m==Slack) return SNotEqualInt(var, v);
+    else if(m==Recursion) return RNotEqualInt(var, v, pol);
+    else return TNotEqualInt(var, v, pol);
+}
+ConstraintsMode blaster_solver::eqMode(bool vi) const{
+    if(atomEqMode >= 0) return (ConstraintsMode)atomEqMode;
+    return vi?viEqMode:vvEqMode;
+}
+ConstraintsMode blaster_solver::compMode(bool vi) const{
+    if(atomCompMode >= 0) return (ConstraintsMode)atomCompMode;
+    return vi?viCompMode:vvCompMode;
+}
+void blaster_solver::setAtomMode(bool eq, int m){
+    if(eq) atomEqMode = m;
+    else atomCompMode = m;
 }
 void blaster_solver::setvvEqMode(ConstraintsMode c){ vvEqMode = c; }
 void blaster_solver::setvvCompMode(ConstraintsMode c){ vvCompMode = c; }
 void blaster_solver::setviEqMode(ConstraintsMode c){ viEqMode = c; }
 void blaster_solver::setviCompMode(ConstraintsMode c){ viCompMode = c; }
+void blaster_solver::setMulMode(MultiplierMode m){ mulMode = m; }
+void blaster_solver::setTerminator(const std::atomic<bool>* flag){ solver->setTerminator(flag); }
+void blaster_solver::setCubes(unsigned n){ solver->setCubes(n); }
+void blaster_solver::setCounting(bool c){ counting = c; }
+bool blaster_solver::isCounting() const{ return counting; }
+int blaster_solver::nVars() const{ return solver->nVars(); }
+int blaster_solver::nClauses() const{ return solver->nClauses(); }
+int64_t blaster_solver::statistic(const char* name) const{ return solver->statistic(name); }
+void blaster_solver::setDeadline(deadline* dl){ solver->setDeadline(dl); }
+void blaster_solver::setExchange(sat_exchange* e, int id){ solver->setExchange(e, id); }
+void blaster_solver::setStamp(int stamp){ solver->setStamp(stamp); }
+
+// the shared clauses are over the bits of the problem variables, indexed from
+// the sign bit, and the literals of the booleans and constraints (bit -1).
+void blaster_solver::share(const void* node, bvar var){
+    if(!solver->sharing() || var->isConstant()) return;
+    for(size_t i=0;i<var->size();i++){
+        literal l = find(var->getAt(i));
+        markUsed(l);
+        solver->share(l, node, i);
+    }
+}
+void blaster_solver::share(const void* node, literal lit){
+    if(!solver->sharing()) return;
+    lit = find(lit);
+    markUsed(lit);
+    solver->share(lit, node, -1);
+}
+
+// split literals of cube-and-conquer: the sign bits of the problem variables,
+// then their bits from the highest one down.
+void blaster_solver::splits(literals& lits, unsigned limit){
+    boost::unordered_set<int> seen;
+    bool more = true;
+    for(unsigned r=0;more && lits.size()<limit;r++){
+        more = false;
+        for(size_t i=0;i<ProblemVars.size() && lits.size()<limit;i++){
+            bvar var = ProblemVars[i];
+            if(var->isConstant() || var->isClean()) continue;
+            if(r > 0 && r >= var->size()) continue;
+            more = true;
+            literal lit = abs(find(var->getAt(r==0?0:var->size()-r)));
+            if(lit == solver->True() || lit == solver->False()) continue;
+            if(seen.find(lit) != seen.end()) continue;
+            seen.insert(lit);
+            lits.emplace_back(lit);
+        }
+    }
+}
 
 // ------------swap operations------------
 void blaster_solver::swap(bvar& a, bvar& b){
@@ -253,3 +436,48 @@ void blaster_solver::swap(bvar& a, bvar& b){
 // ------------information operations------------
 literal blaster_solver::Lit_True() { return solver->True(); }
 literal blaster_solver::Lit_False() { return solver->False(); }
+
+// ------------operation accounting------------
+blaster_solver::scope::scope(blaster_solver* b, OpKind k): bs(b), kind(k){
+    if(!bs->counting) return;
+    vars = bs->solver->nVars();
+    clauses = bs->solver->nClauses();
+    bs->nested.emplace_back(0, 0);
+}
+blaster_solver::scope::~scope(){
+    if(!bs->counting || bs->nested.empty()) return;
+    long v = bs->solver->nVars() - vars;
+    long c = bs->solver->nClauses() - clauses;
+    std::pair<long, long> inner = bs->nested.back();
+    bs->nested.pop_back();
+    statistics::cost& cost = bs->counts[kind];
+    ++cost.calls;
+    cost.vars += v;
+    cost.clauses += c;
+    cost.self_vars += v - inner.first;
+    cost.self_clauses += c - inner.second;
+    if(!bs->nested.empty()){
+        bs->nested.back().first += v;
+        bs->nested.back().second += c;
+    }
+}
+const char* blaster_solver::opName(OpKind k){
+    static const char* names[OpKinds] = {
+        "Add", "Multiply", "MultiplyInt", "Divide", "Modulo", "Ite_num", "Absolute",
+        "Eq.Slack", "Eq.Recursion", "Eq.Transposition",
+        "Comp.Slack", "Comp.Recursion", "Comp.Transposition",
+        "Escape", "Square", "AddMulti"
+    };
+    return names[k];
+}
+void blaster_solver::flushCounts(statistics* st){
+    if(st == nullptr) return;
+    for(int i=0;i<OpKinds;i++){
+        st->add_operation(opName((OpKind)i), counts[i]);
+        counts[i] = statistics::cost();
+    }
+    st->add_count("gates_hashed", gatesHashed);
+    st->add_count("clauses_saved", clausesSaved);
+    st->add_count("lits_merged", litsMerged);
+    gatesHashed = clausesSaved = litsMerged = 0;
+}
@@ -11,8 +11,11 @@
 
 #include "solvers/sat/sat_solver.hpp"
 #include "solvers/blaster/blaster_types.hpp"
+#include "utils/statistics.hpp"
 
 #include <vector>
+#include <deque>
+#include <map>
 #include <string>
 #include <boost/unordered_map.hpp>
 
@@ -20,6 +23,22 @@ using std::to_string;
 namespace ismt
 {
     typedef enum {Slack, Recursion, Transposition} ConstraintsMode;
+    // multiplier: shift-add array, or a compressor tree and a ripple adder.
+    // auto takes the dadda tree once both operands have tree_width bits.
+    typedef enum {ArrayMul, WallaceMul, DaddaMul, AutoMul} MultiplierMode;
+    // operations counted by -stats, the comparators by their mode.
+    typedef enum {
+        OpAdd, OpMultiply, OpMultiplyInt, OpDivide, OpModulo, OpIteNum, OpAbsolute,
+        OpEqSlack, OpEqRecursion, OpEqTransposition,
+        OpCompSlack, OpCompRecursion, OpCompTransposition,
+        OpEscape, OpSquare, OpAddMulti, OpKinds
+    } OpKind;
+    // polarity of a gate in the formula: pos needs only out -> gate, neg only
+    // gate -> out (plaisted-greenbaum), both is the full tseitin encoding.
+    typedef enum {PolPos = 1, PolNeg = 2, PolBoth = 3} Polarity;
+    inline Polarity negated(Polarity p){
+        return (Polarity)(((p & PolPos) << 1) | ((p & PolNeg) >> 1));
+    }
     class blaster_solver
     {
     private:
@@ -51,20 +70,81 @@ namespace ismt
         ConstraintsMode                 vvCompMode;
         ConstraintsMode                 viEqMode;
         ConstraintsMode                 viCompMode;
+        // modes of the atoms blasted next, chosen per atom by the transformer,
+        // -1 for the ones above.
+        int                             atomEqMode = -1;
+        int                             atomCompMode = -1;
+        MultiplierMode                  mulMode = ArrayMul;
+        unsigned                        tree_width = 8;
 
         // eq and comp function pointer
-        literal vvEq            (bvar var1, bvar var2);
-        literal vvGt            (bvar var1, bvar var2);
+        // pol: only the equalities and the zero tests of transposition
+        // are one-sided, the other encodings are always full.
+        literal vvEq            (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal vvGt            (bvar var1, bvar var2, Polarity pol = PolBoth);
         literal vvGe            (bvar var1, bvar var2);
-        literal vvNeq           (bvar var1, bvar var2);
-        literal viEq            (bvar var, bvar v);
-        literal viGt            (bvar var, bvar v);
-        literal viGe            (bvar var, bvar v);
-        literal viNeq           (bvar var, bvar v);
-
-        // auxiliary number
-        unsigned                        auxSize;
-        unsigned                        slackSize;
+        literal vvNeq           (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal viEq            (bvar var, bvar v, Polarity pol = PolBoth);
+        literal viGt            (bvar var, bvar v, Polarity pol = PolBoth);
+        literal viGe            (bvar var, bvar v, Polarity pol = PolBoth);
+        literal viNeq           (bvar var, bvar v, Polarity pol = PolBoth);
+        ConstraintsMode eqMode  (bool vi) const;
+        ConstraintsMode compMode(bool vi) const;
+
+        // anonymous inner variables, recycled by reset.
+        // only the problem variables are named and in n2var.
+        std::deque<blast_variable>      Pool;
+        size_t                          PoolUsed = 0;
+        bvar mkPooled           (unsigned len);
+        // powers made by Power, (base, exponent) -> bvar, until reset.
+        boost::unordered_map<std::pair<bvar, unsigned>, bvar> PowMap;
+        // products by constants made by MultiplyInt, (var, odd constant) -> bvar.
+        std::map<std::pair<bvar, Integer>, bvar> ConstMap;
+        // differences made by Subtract, (var1, var2) -> var1 - var2. their gates
+        // are hashed, so the cost model counts a repeat as free.
+        boost::unordered_map<std::pair<bvar, bvar>, bvar> DiffMap;
+        // quotient and remainder made by DivMod, (var1, var2) -> (q, r), so a
+        // div and a mod of the same operands share one divider.
+        boost::unordered_map<std::pair<bvar, bvar>, std::pair<bvar, bvar>> DivMap;
+
+        // structural hashing: gate kind and normalised inputs -> output,
+        // so equal gates over the same literals are encoded once.
+        // or is an and over the negations, xor keeps the variables and
+        // moves the signs to its output.
+        typedef enum {GateAnd, GateXor, GateMaj, GateIte} GateKind;
+        boost::unordered_map<literals, literal>     GateMap;
+        // one-sided gates: output -> the sides encoded so far, a lookup
+        // asking for more adds the missing clauses. absent is both.
+        boost::unordered_map<literal, int>          GateSides;
+        literals                        gateKey; // reused by the lookups
+        unsigned long                   gatesHashed = 0;
+        unsigned long                   clausesSaved = 0;
+
+        // literal equivalence: a variable in no clause yet that is made equal
+        // to a literal is replaced by it instead of constrained. Rep maps it
+        // to that literal, 0 for a root, and the clauses, the gates and the
+        // model read the literals through find.
+        std::vector<literal>            Rep;
+        std::vector<bool>               Used; // in a clause or shared
+        unsigned long                   litsMerged = 0;
+
+        // per-operation accounting, only with -stats.
+        // a scope charges the vars and clauses made inside it to its kind,
+        // and to the self cost unless a nested scope made them.
+        bool                            counting = false;
+        statistics::cost                counts[OpKinds];
+        std::vector<std::pair<long, long>> nested; // of the open scopes
+        class scope
+        {
+        private:
+            blaster_solver* bs;
+            OpKind          kind;
+            long            vars = 0;
+            long            clauses = 0;
+        public:
+            scope(blaster_solver* b, OpKind k);
+            ~scope();
+        };
 
     public:
         blaster_solver          (std::string n = "cadical");
@@ -75,41 +155,56 @@ namespace ismt
         bvar mkVar              (const std::string& name);
         bvar mkVar              (const std::string& name, unsigned len);
         bvar mkInnerVar         (const std::string& name, unsigned len); // inner var, not appear in model.
+        bvar mkInnerVar         (unsigned len); // anonymous inner var.
+        bvar mkInnerVar         (unsigned len, const Integer& lo, const Integer& hi); // anonymous, values in [lo, hi].
+        bvar mkUnsigned         (const std::string& name, unsigned len); // inner var with a false sign bit.
+        bvar mkUnsigned         (unsigned len); // anonymous, a false sign bit.
         bvar mkInt              (Integer v);
         bvar mkHolder           (const std::string& name, unsigned len); // NEW, a placeholder.
+        bvar mkHolder           (unsigned len); // anonymous placeholder, bits set by the caller.
         bvar blast              (bvar var); // NEW, holder blast to the solver.
         bool_var mkBool         (const std::string& name);
         void addVar             (bvar var); // add a variable to the vector.
         void addVarMap          (bvar var); // add a variable to the map.
         void copy               (bvar var, std::string& name, bvar& target); // deep copy for var.
         void copyInt            (bvar var, bvar& target); // deep copy for var.
+        literal Restrict        (bvar var, unsigned len); // guard literal pinning bits above len.
+        // value ranges: the interval of a variable, else what its width holds.
+        Integer lowerOf         (bvar var) const;
+        Integer upperOf         (bvar var) const;
+        void    setRange        (bvar var, Integer lo, Integer hi); // narrows the known range
+        static unsigned rangeWidth(const Integer& lo, const Integer& hi); // least csize holding [lo, hi]
 
         // logic operations
         literal Not             (const literal&  l);
-        literal And             (const literals& lits);
-        literal And             (const literal& lit1, const literal& lit2);
-        literal Or              (const literals& lits);
-        literal Or              (const literal& lit1, const literal& lit2);
-        literal Ite_bool        (literal cond, literal ifp, literal elp);
-        literal EqualBool       (const literal& lit1, const literal& lit2);
-        literal NotEqualBool    (const literal& lit1, const literal& lit2);
+        // pol: the polarity of the result in the formula, see Polarity.
+        literal And             (const literals& lits, Polarity pol = PolBoth);
+        literal And             (const literal& lit1, const literal& lit2, Polarity pol = PolBoth);
+        literal Or              (const literals& lits, Polarity pol = PolBoth);
+        literal Or              (const literal& lit1, const literal& lit2, Polarity pol = PolBoth);
+        literal Ite_bool        (literal cond, literal ifp, literal elp, Polarity pol = PolBoth);
+        literal EqualBool       (const literal& lit1, const literal& lit2, Polarity pol = PolBoth);
+        literal NotEqualBool    (const literal& lit1, const literal& lit2, Polarity pol = PolBoth);
 
         // math atom operations
-        literal Less            (bvar var1, bvar var2);
-        literal Equal           (bvar var1, bvar var2);
-        literal Greater         (bvar var1, bvar var2);
-        literal NotEqual        (bvar var1, bvar var2);
-        literal LessEqual       (bvar var1, bvar var2);
-        literal GreaterEqual    (bvar var1, bvar var2);
+        literal Less            (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal Equal           (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal Greater         (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal NotEqual        (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal LessEqual       (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal GreaterEqual    (bvar var1, bvar var2, Polarity pol = PolBoth);
 
         // math operations
         bvar Negate             (bvar var);
         bvar Absolute           (bvar var);
         bvar Add                (bvar var1, bvar var2);
+        bvar AddMulti           (const std::vector<bvar>& vars);
         bvar Divide             (bvar var1, bvar var2);
         bvar Modulo             (bvar var1, bvar var2);
         bvar Subtract           (bvar var1, bvar var2);
         bvar Multiply           (bvar var1, bvar var2);
+        bvar Square             (bvar var);
+        bvar Power              (bvar var, unsigned k);
         bvar Ite_num            (literal cond, bvar ifp, bvar elp);
 
         // solve operations
@@ -118,10 +213,16 @@ namespace ismt
         bool solve              (const literals& assumptions);
         bool simplify           ();
         bool simplify           (const literals& assumptions);
+        void getConflict        (literals& assumptions); // failed assumptions of the last unsat solve.
+        bool unsat              () const; // the last solve is unsat, not unknown.
+        void splits             (literals& lits, unsigned limit = 64); // split literals for cubes.
 
         // get operations
         void printModel         ();
         void printStatus        ();
+        int  nVars              () const;
+        int  nClauses           () const;
+        int64_t statistic       (const char* name) const; // of the sat solver
         Integer getValue        (const bvar& var);
         Integer getValue        (const std::string& name);
 
@@ -132,6 +233,31 @@ namespace ismt
         void setvvCompMode      (ConstraintsMode c);
         void setviEqMode        (ConstraintsMode c);
         void setviCompMode      (ConstraintsMode c);
+        void setMulMode         (MultiplierMode m);
+        void setAtomMode        (bool eq, int m); // of the atoms blasted next, -1 for the set modes.
+        void setTerminator      (const std::atomic<bool>* flag);
+        void setCubes           (unsigned n); // cube-and-conquer with n threads.
+        void setDeadline        (deadline* dl);
+        void setExchange        (sat_exchange* e, int id); // share learnt clauses with a group.
+        void setStamp           (int stamp);
+        void share              (const void* node, bvar var); // the bits of a problem variable.
+        void share              (const void* node, literal lit); // a boolean or a constraint.
+        void setCounting        (bool c); // per-operation accounting.
+        bool isCounting         () const;
+        void flushCounts        (statistics* st); // add the counters to st and clear them.
+        static const char* opName(OpKind k);
+
+        // cost model of the comparator encodings for an atom var1 = var2 (eq),
+        // var1 > var2 (strict) or var1 >= var2: estimated vars, clauses and
+        // length of the longest chain, each a unit of the total.
+        struct atomCost{
+            long vars = 0;
+            long clauses = 0;
+            long depth = 0;
+            long total() const { return vars + clauses + depth; }
+        };
+        atomCost estimate       (ConstraintsMode m, bool eq, bool strict, bvar var1, bvar var2) const;
+        ConstraintsMode cheapest(bool eq, bool strict, bvar var1, bvar var2) const;
 
         // reset: clear sat solver, and blaster variables.
         void reset              ();
@@ -150,13 +276,14 @@ namespace ismt
         void swap                   (bvar& a, bvar& b);
 
         // auxiliary functions
-        literal GtZero              (bvar var);
+        literal GtZero              (bvar var, Polarity pol = PolBoth);
         literal GeZero              (bvar var);
         literal LtZero              (bvar var);
-        literal LeZero              (bvar var);
-        literal EqZero              (bvar var);
-        literal NeqZero             (bvar var);
+        literal LeZero              (bvar var, Polarity pol = PolBoth);
+        literal EqZero              (bvar var, Polarity pol = PolBoth);
+        literal NeqZero             (bvar var, Polarity pol = PolBoth);
         // Slack Abstraction: e.g. a > b <=> a == b + t /\ t > 0.
+        bvar mkSlack                (bvar var1, bvar var2); // wide enough for var1 - var2 and var2 - var1
         literal SEqual              (bvar var1, bvar var2);
         literal SNotEqual           (bvar var1, bvar var2);
         literal SGreater            (bvar var1, bvar var2);
@@ -167,64 +294,101 @@ namespace ismt
         literal SGreaterEqualInt    (bvar var1, bvar var2);
 
         // Recursion Abstraction: e.g. a > b <=> a[1] > a[2] or a[1] == a[2] /\ a[2:] > b[2:]
-        literal REqual              (bvar var1, bvar var2);
-        literal RNotEqual           (bvar var1, bvar var2);
+        literal REqual              (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal RNotEqual           (bvar var1, bvar var2, Polarity pol = PolBoth);
         literal RGreater            (bvar var1, bvar var2);
         literal RGreaterEqual       (bvar var1, bvar var2);
-        literal REqualInt           (bvar var1, bvar var2);
-        literal RNotEqualInt        (bvar var1, bvar var2);
+        literal REqualInt           (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal RNotEqualInt        (bvar var1, bvar var2, Polarity pol = PolBoth);
         literal RLessInt            (bvar var, bvar v);
         literal RGreaterInt         (bvar var, bvar v);
-        literal RCompIntLoop        (bvar var, bvar v, bool greater);
         literal RGreaterEqualInt    (bvar var, bvar v);
-        literal RGreaterBit         (const literal& var, const literal& v);
-        literal RLessBitInt         (const literal& var, const literal& v);
-        literal RGreaterBitInt      (const literal& var, const literal& v);
+        literal RCompare            (bvar var1, bvar var2, literal gt); // var1 > var2, or >= with gt true
 
         // Transposition Abstraction: e.g. a > b <=> a - b > 0
-        literal TEqual              (bvar var1, bvar var2);
-        literal TNotEqual           (bvar var1, bvar var2);
-        literal TGreater            (bvar var1, bvar var2);
+        literal TEqual              (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal TNotEqual           (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal TGreater            (bvar var1, bvar var2, Polarity pol = PolBoth);
         literal TGreaterEqual       (bvar var1, bvar var2);
-        literal TEqualInt           (bvar var1, bvar var2);
-        literal TNotEqualInt        (bvar var1, bvar var2);
-        literal TGreaterInt         (bvar var1, bvar var2);
-        literal TGreaterEqualInt    (bvar var1, bvar var2);
+        literal TEqualInt           (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal TNotEqualInt        (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal TGreaterInt         (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal TGreaterEqualInt    (bvar var1, bvar var2, Polarity pol = PolBoth);
 
         // equal operations
         void innerEqualVar          (bvar var1, bvar var2);
         void innerEqualBit          (literal var1, literal var2);
         void innerEqualInt          (bvar var, bvar v);
         void innerEqualBitInt       (literal var, literal v);
-        literal EqualVar            (bvar var1, bvar var2);
-        literal EqualBit            (literal var1, literal var2);
-        literal EqualInt            (bvar var, bvar v);
+        literal EqualVar            (bvar var1, bvar var2, Polarity pol = PolBoth);
+        literal EqualBit            (literal var1, literal var2, Polarity pol = PolBoth);
+        literal EqualInt            (bvar var, bvar v, Polarity pol = PolBoth);
         literal EqualBitInt         (literal var, literal v);
         literal NotEqualVar         (bvar var1, bvar var2);
-        literal NotEqualBit         (literal var1, literal var2);
-        literal NotEqualInt         (bvar var, bvar v);
+        literal NotEqualBit         (literal var1, literal var2, Polarity pol = PolBoth);
+        literal NotEqualInt         (bvar var, bvar v, Polarity pol = PolBoth);
         literal NotEqualBitInt      (literal var, literal v);
 
         // auxiliary functions for math operations
-        bvar Add                    (bvar var1, bvar var2, bool addone);
+        bvar Add                    (bvar var1, bvar var2, bool addone, bool carry = false); // carry: plus one
         bvar Invert                 (bvar var);
         bvar AddOne                 (bvar var);
         bvar MultiplyInt            (bvar var, bvar v);
+        bvar MultiplyConst          (bvar var, const Integer& v);
         bvar MultiplyBit            (bvar var, literal bit, unsigned len);
         bvar MultiplyBitInt         (bvar var, literal bit, unsigned len); // NEW
         bvar Shift                  (bvar var, int len);
         bvar ShiftAdd               (bvar subsum, bvar subans, bvar answer, unsigned idx);
+        // euclidean division: x = q * y + r, 0 <= r < |y|, of both div and mod.
+        void DivMod                 (bvar var1, bvar var2, bvar& q, bvar& r);
+        void DivModInt              (bvar var1, bvar var2, bvar& q, bvar& r); // by a constant
+        void RestoringDivide        (const literals& a, const literals& b, literals& q, literals& r); // unsigned
+        literal NegateIf            (literal s, literals& bits, bool carry = false); // -bits if s, in place
+        // compressor tree: the low bits of varmax * varmin into answer[1..]
+        void MultiplyTree           (bvar varmax, bvar varmin, bvar answer, bool dadda);
+        void sumColumns             (std::vector<literals>& cols, bvar answer, bool dadda);
+        void reduceWallace          (std::vector<literals>& cols);
+        void reduceDadda            (std::vector<literals>& cols, size_t target);
+        void reduceColumn           (std::vector<literals>& cols, std::vector<literals>& next, size_t c, size_t target);
+        literal AndGate             (literal a, literal b);
+        literal XorGate             (literal a, literal b, literal c = 0);
+        literal MajGate             (literal a, literal b, literal c);
+        void FullAdd                (literal a, literal b, literal c, literal& sum, literal& cry);
+        void HalfAdd                (literal a, literal b, literal& sum, literal& cry);
         // bool_var MultiplySignBit    (bvar var1, bvar var2);
 
+        // structural hashing
+        // pol: the sides needed of the output, a lookup adds the missing ones.
+        literal findGate            (GateKind k, const literal* in, unsigned n, Polarity pol = PolBoth); // 0 if not made yet
+        void    keepGate            (GateKind k, const literal* in, unsigned n, literal out, Polarity pol = PolBoth);
+        void    emitGate            (GateKind k, const literal* in, unsigned n, literal out, Polarity pol); // clauses of one or both sides
+        literal findXor             (literal a, literal b, literal c = 0, Polarity pol = PolBoth);
+        literal findMaj             (literal a, literal b, literal c);
+        void    keepXor             (literal out, literal a, literal b, literal c = 0, Polarity pol = PolBoth);
+        bool    hashedGate          (literal out, literal gate, unsigned clauses); // bind out to gate
+
+        // literal equivalence
+        literal find                (literal l); // the representative of l
+        bool    merge               (literal a, literal b); // a == b by substitution, false if both are used
+        void    markUsed            (literal l);
+
+        // known bits: a literal of true or false is known, and equal literals
+        // are the same bit, so the gates fold them before any clause.
+        int     knownBit            (literal l); // 1, 0, or -1 if free
+        literal bitOf               (bvar var, size_t i); // sign extended, a literal also for constants
+        unsigned foldXor            (literal* in, unsigned n, bool& parity); // free inputs left in in
+
         // inner auxiliary functions for math operations
         void doCarry                (literal cry1, literal varmax, literal varmin, literal cry0);
         void doTarget               (literal target, literal varmax, literal varmin, literal cry);
         void doCarryInt             (literal cry1, literal var, literal ivar, literal cry0);
         void doTargetInt            (literal target, literal var, literal ivar, literal cry);
+        void doAnd                  (literal target, literal var1, literal var2); // target == var1 /\ var2
 
 
         // calculate value from bit-blasting
         Integer calculate          (bvar var); // after getModel, calculate real value.
+        bool    valueOf            (literal l) const; // after getModel
 
         // get model 
         void getModel               ();
@@ -235,6 +399,13 @@ namespace ismt
 
         // add clause to sat solver
         void addClause              (clause& c);
+        // the short clauses of the gates, normalised on the stack.
+        void addClause1             (literal a);
+        void addClause2             (literal a, literal b);
+        void addClause3             (literal a, literal b, literal c);
+        void addClause4             (literal a, literal b, literal c, literal d);
+        void emitClause             (literal* lits, unsigned n);
+        clause                      buffer; // reused by addClause
 
         // output error and exit
         void outputError            (const std::string& mesg);
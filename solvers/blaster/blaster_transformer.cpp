@@ -16,7 +16,32 @@ using namespace ismt;
 
 // New: 2021-11-17, transformer has simplifier power.
 int blaster_transformer::transform(dagc* root){
-    return doAtoms(root);
+    // the literal is only assumed true, so the root is positive.
+    if(!solver->isCounting()) return doAtoms(root, PolPos);
+    long vars = solver->nVars();
+    long clauses = solver->nClauses();
+    int lit = doAtoms(root, PolPos);
+    std::pair<long, long>& cost = CostMap[root];
+    cost.first += solver->nVars() - vars;
+    cost.second += solver->nClauses() - clauses;
+    return lit;
+}
+void blaster_transformer::flushCosts(statistics* st){
+    if(st == nullptr) return;
+    auto it = CostMap.begin();
+    while(it != CostMap.end()){
+        st->add_constraint(it->first, it->second.first, it->second.second);
+        ++it;
+    }
+    CostMap.clear();
+    for(int k=0;k<2;k++){
+        for(int m=0;m<3;m++){
+            if(AtomModes[k][m] == 0) continue;
+            OpKind op = (OpKind)((k==0?OpEqSlack:OpCompSlack) + m);
+            st->add_count(std::string("atoms.") + blaster_solver::opName(op), AtomModes[k][m]);
+            AtomModes[k][m] = 0;
+        }
+    }
 }
 
 bool blaster_transformer::isFree(Integer lower, bool a_open, Integer upper, bool b_open){
@@ -110,6 +135,7 @@ void blaster_transformer::_declare(dagc* root, unsigned bit){
     #endif
 
     res->setZero();
+    solver->share(root, res);
 }
 void blaster_transformer::_declare(dagc* root, Integer lower, bool a_open, Integer upper, bool b_open){
     if(lower > upper) assert(false);
@@ -125,9 +151,14 @@ void blaster_transformer::_declare(dagc* root, Integer lower, bool a_open, Integ
         if(VarMap.find(root)!=VarMap.end()){
             not_in = false;
             res = VarMap[root];
-            // if(res->isConstant()) return;
-            // else if(!res->isClean()) res->clear();
-            if(!res->isClean()) res->clear();
+            if(!res->isClean()){
+                // declared in this encoding: the blasted terms and the cached
+                // literals read its bits, so new bounds need a new encoding.
+                auto it = DeclareMap.find(root);
+                if(it == DeclareMap.end() || it->second.lower != lower || it->second.a_open != a_open ||
+                   it->second.upper != upper || it->second.b_open != b_open) is_outgrown = true;
+                return;
+            }
         }
         assert(res == nullptr || res->isClean());
 
@@ -145,20 +176,22 @@ void blaster_transformer::_declare(dagc* root, Integer lower, bool a_open, Integ
             int bit_middle = split_middle(lower, a_open, upper, b_open);
             if(bit_middle <= 0){
                 int bits = bit_lower<=0?blastBitLength(upper - lower + 1):bit_lower;
-                bvar t = solver->mkInnerVar(root->name+"_offset", bits);
+                // t >= 0: unsigned
+                bvar t = solver->mkUnsigned(root->name+"_offset", bits);
+
+                if(bit_lower <= 0){
+                    if(b_open) solver->Assert(solver->Less(t, solver->mkInt(upper - lower)));
+                    else solver->Assert(solver->LessEqual(t, solver->mkInt(upper - lower)));
+                }
+                // the asserted range of t, the operations on x are sized by it
+                if(bit_lower <= 0) solver->setRange(t, 0, b_open?Integer(upper - lower - 1):Integer(upper - lower));
+
                 if(lower == 0){
                     solver->copy(t, root->name, res);
                 }
                 else{
                     solver->copy(solver->Add(t, solver->mkInt(lower)), root->name, res);
                 }
-                
-                solver->Assert(solver->GreaterEqual(t, solver->mkInt(0)));
-
-                if(bit_lower <= 0){
-                    if(b_open) solver->Assert(solver->Less(t, solver->mkInt(upper - lower)));
-                    else solver->Assert(solver->LessEqual(t, solver->mkInt(upper - lower)));
-                }
                 #if decDebug
                     std::cout<<"declare variable( "<<root->name<<" ) with lower offset ( "<<root->name<<" = "<<lower<<" + t).\n";
                 #endif
@@ -189,10 +222,115 @@ void blaster_transformer::_declare(dagc* root, Integer lower, bool a_open, Integ
             solver->addVarMap(res);
             VarMap.insert(std::pair<dagc*, bvar>(root, res));
         }
+        declaration& d = DeclareMap[root];
+        d.lower = lower; d.a_open = a_open;
+        d.upper = upper; d.b_open = b_open;
+        solver->share(root, res);
     }
 }
+literal blaster_transformer::guard(reservation& r, Integer span, int bits){
+    if(r.guards.find(span) != r.guards.end()) return r.guards[span];
+    literal g = solver->Restrict(r.offset, bits);
+    if(!r.middle && getBitLength(span + 1) <= 0){
+        // x in [l, u] but u - l + 1 is not a power of 2, so t <= u - l as well.
+        g = solver->And(g, solver->LessEqual(r.offset, solver->mkInt(span)));
+    }
+    r.guards.insert(std::pair<Integer, literal>(span, g));
+    return g;
+}
+void blaster_transformer::_reserve(dagc* root, Integer lower, bool a_open, Integer upper, bool b_open, bool above){
+    if(a_open) lower = lower + 1;
+    if(b_open) upper = upper - 1;
+    assert(lower < upper);
+
+    // the same shape as _declare: x = lower + t or x = mid + t.
+    // above: the box keeps its upper end, so x = upper - t keeps the base.
+    int bit_lower = split_lower(lower, false, upper, false);
+    int bit_middle = split_middle(lower, false, upper, false);
+    bool middle = !above && bit_middle > 0;
+    int bits = middle?bit_middle:(bit_lower<=0?blastBitLength(upper - lower + 1):bit_lower);
+    Integer base = middle?Integer((lower + upper) / 2):(above?upper:lower);
+
+    if(ReserveMap.find(root) != ReserveMap.end()){
+        reservation& r = ReserveMap[root];
+        if(r.middle == middle && r.above == above && r.base == base && bits <= r.width){
+            setGuard(root, guard(r, upper - lower, bits));
+        }
+        else is_outgrown = true;
+        return;
+    }
+
+    bvar res = nullptr;
+    bool not_in = true;
+    if(VarMap.find(root)!=VarMap.end()){
+        not_in = false;
+        res = VarMap[root];
+        if(!res->isClean()){
+            // declared without reservation in this encoding.
+            is_outgrown = true;
+            return;
+        }
+    }
+
+    reservation r;
+    r.middle = middle;
+    r.above = above;
+    r.base = base;
+    r.width = std::max(bits, std::min((int)(bits * reserve_factor), (int)MaxReserve));
+    if(middle){
+        r.offset = solver->mkInnerVar(root->name+"_mid_offset", r.width);
+        solver->copy(solver->Add(r.offset, solver->mkInt(base)), root->name, res);
+    }
+    else{
+        // t >= 0: unsigned, the guards narrow it further
+        r.offset = solver->mkUnsigned(root->name+"_offset", r.width);
+        if(above) solver->copy(solver->Subtract(solver->mkInt(base), r.offset), root->name, res);
+        else if(base == 0) solver->copy(r.offset, root->name, res);
+        else solver->copy(solver->Add(r.offset, solver->mkInt(base)), root->name, res);
+    }
+    #if decDebug
+        std::cout<<"reserve variable( "<<root->name<<" ) with bit-width ( "<<bits<<" / "<<r.width<<" bits ).\n";
+    #endif
+
+    if(lower > 0 || upper < 0) res->unsetZero();
+    else res->setZero();
+
+    if(not_in){
+        solver->addVar(res);
+        solver->addVarMap(res);
+        VarMap.insert(std::pair<dagc*, bvar>(root, res));
+    }
+    ReserveMap.insert(std::pair<dagc*, reservation>(root, r));
+    setGuard(root, guard(ReserveMap[root], upper - lower, bits));
+}
+void blaster_transformer::setGuard(dagc* root, literal g){
+    if(GuardMap.find(root) == GuardMap.end()) Guarded.emplace_back(root);
+    GuardMap[root] = g;
+}
+void blaster_transformer::guards(literals& lits){
+    for(size_t i=0;i<Guarded.size();i++){
+        lits.emplace_back(GuardMap[Guarded[i]]);
+    }
+}
+void blaster_transformer::guarded(const literals& core, std::vector<dagc*>& vars){
+    boost::unordered_set<literal> failed(core.begin(), core.end());
+    for(size_t i=0;i<Guarded.size();i++){
+        if(failed.find(GuardMap[Guarded[i]]) != failed.end()){
+            vars.emplace_back(Guarded[i]);
+        }
+    }
+}
+bool blaster_transformer::outgrown() const{
+    return is_outgrown;
+}
+void blaster_transformer::unguard(){
+    GuardMap.clear();
+    Guarded.clear();
+}
 int blaster_transformer::_assert(dagc* root){
-    return transform(root);
+    int lit = transform(root);
+    solver->share(root, lit);
+    return lit;
 }
 
 void blaster_transformer::declareInt(dagc* root){
@@ -220,7 +358,7 @@ int blaster_transformer::getLetBool(dagc* root){
         if(BoolOprMap.find(root->children[0]) != BoolOprMap.end()){
             ans = BoolOprMap[root->children[0]];
         }
-        else ans = doAtoms(root->children[0]);
+        else ans = doAtoms(root->children[0], PolBoth);
         BoolLetMap.insert(std::pair<dagc*, int>(root, ans));
         return ans;
     }
@@ -236,7 +374,7 @@ void blaster_transformer::declareBool(dagc* root){
         t = solver->mkBool(root->name);
     }
     BoolMap.insert(std::pair<dagc*, int>(root, t));
-
+    solver->share(root, t);
 }
 
 void blaster_transformer::reset(blaster_solver* s){
@@ -247,12 +385,22 @@ void blaster_transformer::reset(blaster_solver* s){
     BoolOprMap.clear();
     NumLetMap.clear();
     IntFunMap.clear();
+    ReserveMap.clear();
+    DeclareMap.clear();
+    GuardMap.clear();
+    Guarded.clear();
+    is_outgrown = false;
     // a new solver
     solver = s;
     VarMap.clear();
     IntMap.clear();
 }
 void blaster_transformer::reset(){
+    ReserveMap.clear();
+    DeclareMap.clear();
+    GuardMap.clear();
+    Guarded.clear();
+    is_outgrown = false;
     BoolMap.clear();
     BoolLetMap.clear();
     BoolFunMap.clear();
@@ -299,6 +447,8 @@ bvar blaster_transformer::doMathTerms(dagc* dag){
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" mod "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
+        // the operands are the bvars of OprMap, so a div of the same children
+        // finds the divider of this mod in the solver, and the other way round.
         bvar t = solver->Modulo(parameters[0], parameters[1]);
         OprMap.insert(std::pair<dagc*, bvar>(dag, t));
         return t;
@@ -320,6 +470,12 @@ bvar blaster_transformer::doMathTerms(dagc* dag){
             }
             std::cout<<" )"<<std::endl;
         #endif
+        // one carry-save tree for the whole sum
+        if(CSA && parameters.size() > 2){
+            bvar t = solver->AddMulti(parameters);
+            OprMap.insert(std::pair<dagc*, bvar>(dag, t));
+            return t;
+        }
         // sort addition
         bvar ans = nullptr;
         while(parameters.size() > 1){
@@ -341,9 +497,18 @@ bvar blaster_transformer::doMathTerms(dagc* dag){
             }
             std::cout<<" )"<<std::endl;
         #endif
-        bvar ans = parameters[0];
-        for(size_t i=1;i<parameters.size();i++){
-            ans = solver->Multiply(ans, parameters[i]);
+        // x^k is expanded to k factors x, they are counted back and
+        // blasted by repeated squaring.
+        std::vector<std::pair<bvar, unsigned>> factors;
+        for(size_t i=0;i<parameters.size();i++){
+            size_t j = 0;
+            while(j<factors.size() && factors[j].first!=parameters[i]) j++;
+            if(j<factors.size()) ++factors[j].second;
+            else factors.emplace_back(parameters[i], 1);
+        }
+        bvar ans = solver->Power(factors[0].first, factors[0].second);
+        for(size_t i=1;i<factors.size();i++){
+            ans = solver->Multiply(ans, solver->Power(factors[i].first, factors[i].second));
         }
         bvar t = ans;
         OprMap.insert(std::pair<dagc*, bvar>(dag, t));
@@ -391,7 +556,7 @@ bvar blaster_transformer::doIteNums(dagc* dag){
     return t;
 }
 
-int blaster_transformer::doMathAtoms(dagc* dag){
+int blaster_transformer::doMathAtoms(dagc* dag, Polarity pol){
     assert(dag->iscomp());
     std::vector<bvar> parameters;
     for(size_t i=0;i<dag->children.size();i++){
@@ -404,61 +569,83 @@ int blaster_transformer::doMathAtoms(dagc* dag){
         else{ tmp->print(); std::cout<<"Error dag node type (in math atoms)! "<<std::endl; assert(false); }
     }
     assert(parameters.size()==2);
+    // the encoding of this atom, oriented as var1 = var2, var1 > var2 or
+    // var1 >= var2 for the cost model.
+    bool eq = dag->iseq() || dag->isneq();
+    bool swapped = dag->islt() || dag->isle();
+    bvar var1 = swapped? parameters[1]: parameters[0];
+    bvar var2 = swapped? parameters[0]: parameters[1];
+    int mode = eq? EqMode: CompMode;
+    // a folded atom has no encoding
+    if(var1 != var2 && (!var1->isConstant() || !var2->isConstant())){
+        if(mode < 0) mode = solver->cheapest(eq, dag->isgt() || dag->islt(), var1, var2);
+        ++AtomModes[eq? 0: 1][mode];
+    }
+    solver->setAtomMode(eq, mode);
+    literal ans = 0;
     // 2012-11-17: new simplifier for operations by using variables' intervals.
     if(dag->iseq()){
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" == "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
-        return solver->Equal(parameters[0], parameters[1]);
+        ans = solver->Equal(parameters[0], parameters[1], pol);
     }
     else if(dag->isneq()){
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" != "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
-        return solver->NotEqual(parameters[0], parameters[1]);
+        ans = solver->NotEqual(parameters[0], parameters[1], pol);
     }
     else if(dag->isle()){ // x <= y
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" <= "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
-        return solver->LessEqual(parameters[0], parameters[1]);
+        ans = solver->LessEqual(parameters[0], parameters[1], pol);
     }
     else if(dag->islt()){ // x < y
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" < "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
-        return solver->Less(parameters[0], parameters[1]);
+        ans = solver->Less(parameters[0], parameters[1], pol);
     }
     else if(dag->isge()){ // x >= y
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" >= "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
-        return solver->GreaterEqual(parameters[0], parameters[1]);
+        ans = solver->GreaterEqual(parameters[0], parameters[1], pol);
     }
     else if(dag->isgt()){
         #if doDebug
             std::cout<<"( "<<parameters[0]->getName()<<" > "<<parameters[1]->getName()<<" )"<<std::endl;
         #endif
-        return solver->Greater(parameters[0], parameters[1]);
+        ans = solver->Greater(parameters[0], parameters[1], pol);
     }
     else std::cout<<"Error math atom operatios! "<<std::endl, assert(false);
+    // the terms of the next atoms keep the set modes
+    solver->setAtomMode(eq, -1);
+    return ans;
 }
 
-int blaster_transformer::doAtoms(dagc* dag){
+int blaster_transformer::doAtoms(dagc* dag, Polarity pol){
     // if(BoolOprMap.find(dag)!=BoolOprMap.end()) return BoolOprMap[dag]; // fast finding.
     if(dag->isand()||dag->isor()||dag->isnot()||dag->isitebool()||dag->iseqbool()||dag->isneqbool()){
         std::vector<int> parameters;
         for(size_t i=0;i<dag->children.size();i++){
             dagc* tmp = dag->children[i];
-            if(tmp->isboolop()) parameters.emplace_back(doAtoms(tmp));
-            else if(tmp->isnumop()) parameters.emplace_back(doMathAtoms(tmp));
+            // polarity of the child: not flips it, a condition or a side of
+            // an equivalence occurs in both.
+            Polarity sub = pol;
+            if(dag->isnot()) sub = negated(pol);
+            else if(dag->iseqbool()||dag->isneqbool()||(dag->isitebool()&&i==0)) sub = PolBoth;
+            if(tmp->isboolop()) parameters.emplace_back(doAtoms(tmp, sub));
+            else if(tmp->isnumop()) parameters.emplace_back(doMathAtoms(tmp, sub));
             else if(tmp->isvbool()) parameters.emplace_back(BoolMap[tmp]);
             else if(tmp->iscbool()) parameters.emplace_back(tmp->v==1?solver->Lit_True():solver->Lit_False()); // 1 for true, 0 for false.
-            else if(tmp->isitebool()) parameters.emplace_back(doAtoms(tmp));
+            else if(tmp->isitebool()) parameters.emplace_back(doAtoms(tmp, sub));
             else if(tmp->isletbool()) parameters.emplace_back(getLetBool(tmp));  // tmp must have been declared, else error.
-            else if(tmp->islet()) parameters.emplace_back(doLetAtoms(tmp));
-            else if(tmp->iseqbool()) parameters.emplace_back(doAtoms(tmp));
-            else if(tmp->isneqbool()) parameters.emplace_back(doAtoms(tmp));
+            else if(tmp->islet()) parameters.emplace_back(doLetAtoms(tmp, sub));
+            else if(tmp->iseqbool()) parameters.emplace_back(doAtoms(tmp, sub));
+            else if(tmp->isneqbool()) parameters.emplace_back(doAtoms(tmp, sub));
             else{ tmp->print(); std::cout<<"Error dag node type (in logic atoms)! "<<std::endl, assert(false);}
             // 2012-11-17: new simplifier for and/or.
             int prop = parameters.back();
@@ -486,8 +673,8 @@ int blaster_transformer::doAtoms(dagc* dag){
                 }
                 std::cout<<parameters[parameters.size()-1]<<" ) )"<<std::endl;
             #endif
-            int ans = solver->And(parameters);
-            BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+            int ans = solver->And(parameters, pol);
+            if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
             return ans;
         }
         else if(dag->isor()){
@@ -498,8 +685,8 @@ int blaster_transformer::doAtoms(dagc* dag){
                 }
                 std::cout<<parameters[parameters.size()-1]<<" ) )"<<std::endl;
             #endif
-            int ans = solver->Or(parameters);
-            BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+            int ans = solver->Or(parameters, pol);
+            if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
             return ans;
         }
         else if(dag->isnot()){
@@ -508,7 +695,7 @@ int blaster_transformer::doAtoms(dagc* dag){
                 std::cout<<"( Not( "<<parameters[0]<<" ) )"<<std::endl;
             #endif
             int ans = solver->Not(parameters[0]);
-            BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+            if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
             return ans;
         }
         else if(dag->isitebool()){
@@ -518,8 +705,8 @@ int blaster_transformer::doAtoms(dagc* dag){
                 std::cout<<"( if ( "<<parameters[0]<<" ) then "<<parameters[1]<<" else "<<parameters[2]<<" )"<<std::endl;
             #endif
             if(parameters[1]==parameters[2]) return parameters[1];
-            int ans = solver->Ite_bool(parameters[0], parameters[1], parameters[2]);
-            BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+            int ans = solver->Ite_bool(parameters[0], parameters[1], parameters[2], pol);
+            if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
             return ans;
         }
         else if(dag->iseqbool()){
@@ -528,8 +715,8 @@ int blaster_transformer::doAtoms(dagc* dag){
                 std::cout<<"( ( "<<parameters[0]<<" ) ==b ( "<<parameters[1]<<" ) )"<<std::endl;
             #endif
             if(parameters[0]==parameters[1]) return solver->Lit_True();
-            int ans = solver->EqualBool(parameters[0], parameters[1]);
-            BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+            int ans = solver->EqualBool(parameters[0], parameters[1], pol);
+            if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
             return ans;
         }
         else if(dag->isneqbool()){
@@ -538,15 +725,15 @@ int blaster_transformer::doAtoms(dagc* dag){
             #if doDebug
                 std::cout<<"( ( "<<parameters[0]<<" ) != ( "<<parameters[1]<<" ) )"<<std::endl;
             #endif
-            int ans = solver->NotEqualBool(parameters[0], parameters[1]);
-            BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+            int ans = solver->NotEqualBool(parameters[0], parameters[1], pol);
+            if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
             return ans;
         }
         else std::cout<<"Error logic operatios (in logic atoms)! "<<std::endl, assert(false);
     }
     else if(dag->iscomp()){
-        int ans = doMathAtoms(dag);
-        BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
+        int ans = doMathAtoms(dag, pol);
+        if(pol==PolBoth) BoolOprMap.insert(std::pair<dagc*, int>(dag, ans));
         return ans;
     }
     else if(dag->iscbool()){
@@ -564,7 +751,7 @@ int blaster_transformer::doAtoms(dagc* dag){
     }
     else if(dag->islet()){
         // only use one times, so no need to add to map
-        return doLetAtoms(dag);
+        return doLetAtoms(dag, pol);
     }
     else if(dag->isletbool()){
         // this node must have been set.
@@ -595,7 +782,7 @@ bvar blaster_transformer::doLetNum(dagc* dag){
 }
 
 // doLetAtoms will never invoked.
-int blaster_transformer::doLetAtoms(dagc* dag){
+int blaster_transformer::doLetAtoms(dagc* dag, Polarity pol){
     assert(dag->islet());
     std::vector<dagc* > key_list; 
     
@@ -607,7 +794,7 @@ int blaster_transformer::doLetAtoms(dagc* dag){
             dagc* child = formula->children[i];
             key_list.emplace_back(child);
             if(child->isletbool()){
-                int ans = doAtoms(child->children[0]);
+                int ans = doAtoms(child->children[0], PolBoth);
                 BoolLetMap.insert(std::pair<dagc*, int>(child, ans));
             }
             else if(child->isletnum()){
@@ -618,7 +805,7 @@ int blaster_transformer::doLetAtoms(dagc* dag){
         }
         formula = formula->children[0];
     }
-    int answer = doAtoms(formula);
+    int answer = doAtoms(formula, pol);
 
     // clear variable map. for they are local variables.
     while (key_list.size() > 0) {
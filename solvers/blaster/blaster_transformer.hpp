@@ -13,6 +13,8 @@
 
 // 2023-05-27
 #include "options.hpp"
+#include <map>
+#include <boost/unordered_set.hpp>
 
 namespace ismt
 {   
@@ -29,13 +31,43 @@ namespace ismt
         boost::unordered_map<dagc*, int>    BoolMap;
         boost::unordered_map<dagc*, int>    BoolLetMap;
         boost::unordered_map<dagc*, int>    BoolFunMap;
-        boost::unordered_map<dagc*, int>    BoolOprMap;
+        boost::unordered_map<dagc*, int>    BoolOprMap; // only full encodings, lets reuse them
         boost::unordered_map<dagc*, bvar>   VarMap;
         boost::unordered_map<dagc*, bvar>   IntMap;
         boost::unordered_map<dagc*, bvar>   OprMap;
         boost::unordered_map<dagc*, bvar>   NumLetMap;
         boost::unordered_map<dagc*, bvar>   IntFunMap;
 
+        // incremental widening: a boxed variable is blasted once at a reserved
+        // width, and the bits above its current box are pinned to the sign bit
+        // by a guard literal that is passed to the sat solver as an assumption.
+        struct reservation{
+            bvar    offset = nullptr;
+            bool    middle = false;
+            bool    above = false; // x = base - t, the box grows downwards
+            Integer base = 0;
+            int     width = 0;
+            std::map<Integer, literal> guards; // span of the box -> guard
+        };
+        boost::unordered_map<dagc*, reservation>    ReserveMap;
+        // the bounds of the variables declared without reservation, a kept
+        // encoding may only declare them again with the same bounds.
+        struct declaration{
+            Integer lower = 0, upper = 0;
+            bool    a_open = false, b_open = false;
+        };
+        boost::unordered_map<dagc*, declaration>    DeclareMap;
+        boost::unordered_map<dagc*, literal>        GuardMap; // guards of this round
+        std::vector<dagc*>                          Guarded;  // in order of declaration
+        unsigned    reserve_factor = 4;
+        bool        is_outgrown = false;
+
+        // -stats: vars and clauses blasted for each top-level constraint.
+        // a term shared by constraints is charged to the first one.
+        boost::unordered_map<dagc*, std::pair<long, long>> CostMap;
+        // -stats: math atoms by kind (eq, comp) and the encoding they got.
+        unsigned long AtomModes[2][3] = {{0, 0, 0}, {0, 0, 0}};
+
         // declare a int to blaster
         void declareInt(dagc* root);
         bvar getInt(dagc* root);
@@ -47,9 +79,11 @@ namespace ismt
         void declareBool(dagc* root);
 
         // transform
-        int         doAtoms(dagc* dag);
-        int         doMathAtoms(dagc* dag);
-        int         doLetAtoms(dagc* dag);
+        // pol: how the atom occurs in the assertion, a positive one only needs
+        // its literal to imply the atom, a negative one the converse.
+        int         doAtoms(dagc* dag, Polarity pol = PolBoth);
+        int         doMathAtoms(dagc* dag, Polarity pol = PolBoth);
+        int         doLetAtoms(dagc* dag, Polarity pol = PolBoth);
         bvar        doIteNums(dagc* dag);
         bvar        doMathTerms(dagc* dag);
         bvar        doLetNum(dagc* dag);
@@ -58,6 +92,8 @@ namespace ismt
         int         split_lower(Integer lower, bool a_open, Integer upper, bool b_open);
         int         split_middle(Integer lower, bool a_open, Integer upper, bool b_open);
         void        _declare(dagc* root, unsigned bit);
+        literal     guard(reservation& r, Integer span, int bits);
+        void        setGuard(dagc* root, literal g);
 
     public:
         blaster_transformer(blaster_solver* s){ solver = s; }
@@ -65,6 +101,12 @@ namespace ismt
 
         // 2023-05-27
         bool        GA = true;
+        bool        CSA = true;
+        unsigned    MaxReserve = 128;
+        // comparator encodings of the math atoms, -1 for the cheapest one
+        // of the cost model of the blaster.
+        int         EqMode = -1;
+        int         CompMode = -1;
 
         // transform a constraint to blaster
         int transform(dagc* root);
@@ -73,7 +115,21 @@ namespace ismt
         void _declare(dagc* root, Integer lower, bool a_open, Integer upper, bool b_open);
         void _declare(dagc* root);
         int  _assert(dagc* root);
+
+        // declare a boxed var whose box may grow in later rounds (incremental widening)
+        void _reserve(dagc* root, Integer lower, bool a_open, Integer upper, bool b_open, bool above = false);
+        // guards of the current round, as assumptions
+        void guards(literals& lits);
+        // variables whose guard is in the core
+        void guarded(const literals& core, std::vector<dagc*>& vars);
+        // a reserved var needs more bits than it reserved, so re-blast
+        bool outgrown() const;
+        // start a new round: keep the encoding, drop the guards
+        void unguard();
         
+        // add the costs of the constraints to st and clear them
+        void flushCosts(statistics* st);
+
         // clear variables
         void reset(blaster_solver* s);
         void reset();
@@ -11,42 +11,42 @@ using namespace ismt;
 
 
 // Transposition Abstraction: e.g. a > b <=> a - b > 0
-literal blaster_solver::TEqual(bvar var1, bvar var2){
+literal blaster_solver::TEqual(bvar var1, bvar var2, Polarity pol){
     bvar ans = Subtract(var1, var2);
-    return EqZero(ans);
+    return EqZero(ans, pol);
 }
-literal blaster_solver::TNotEqual(bvar var1, bvar var2){
+literal blaster_solver::TNotEqual(bvar var1, bvar var2, Polarity pol){
     bvar ans = Subtract(var1, var2);
-    return NeqZero(ans);
+    return NeqZero(ans, pol);
 }
-literal blaster_solver::TGreater(bvar var1, bvar var2){
+literal blaster_solver::TGreater(bvar var1, bvar var2, Polarity pol){
     bvar ans = Subtract(var1, var2);
-    return GtZero(ans);
+    return GtZero(ans, pol);
 }
 literal blaster_solver::TGreaterEqual(bvar var1, bvar var2){
     bvar ans = Subtract(var1, var2);
     return GeZero(ans);
 }
-literal blaster_solver::TEqualInt(bvar var, bvar v){
-    if(var->isConstant() && var->getCurValue()==0) return EqZero(v);
-    else if(v->isConstant() && v->getCurValue()==0) return EqZero(var); 
+literal blaster_solver::TEqualInt(bvar var, bvar v, Polarity pol){
+    if(var->isConstant() && var->getCurValue()==0) return EqZero(v, pol);
+    else if(v->isConstant() && v->getCurValue()==0) return EqZero(var, pol); 
     bvar ans = Subtract(var, v);
-    return EqZero(ans);
+    return EqZero(ans, pol);
 }
-literal blaster_solver::TNotEqualInt(bvar var, bvar v){
-    if(var->isConstant() && var->getCurValue()==0) return NeqZero(v);
-    else if(v->isConstant() && v->getCurValue()==0) return NeqZero(var); 
+literal blaster_solver::TNotEqualInt(bvar var, bvar v, Polarity pol){
+    if(var->isConstant() && var->getCurValue()==0) return NeqZero(v, pol);
+    else if(v->isConstant() && v->getCurValue()==0) return NeqZero(var, pol); 
     bvar ans = Subtract(var, v);
-    return NeqZero(ans);
+    return NeqZero(ans, pol);
 }
-literal blaster_solver::TGreaterInt(bvar var, bvar v){
+literal blaster_solver::TGreaterInt(bvar var, bvar v, Polarity pol){
     if(var->isConstant() && var->getCurValue() == 0) return LtZero(v);
-    else if(v->isConstant() && v->getCurValue() == 0) return GtZero(var);
+    else if(v->isConstant() && v->getCurValue() == 0) return GtZero(var, pol);
     bvar ans = Subtract(var, v);
-    return GtZero(ans);
+    return GtZero(ans, pol);
 }
-literal blaster_solver::TGreaterEqualInt(bvar var, bvar v){
-    if(var->isConstant() && var->getCurValue() == 0) return LeZero(v);
+literal blaster_solver::TGreaterEqualInt(bvar var, bvar v, Polarity pol){
+    if(var->isConstant() && var->getCurValue() == 0) return LeZero(v, pol);
     else if(v->isConstant() && v->getCurValue() == 0) return GeZero(var);
     bvar ans = Subtract(var, v);
     return GeZero(ans);
@@ -20,6 +20,7 @@ namespace ismt
     const int mask_constant = 1;
     const int mask_clear = 2;
     const int mask_zero = 4;
+    const int mask_range = 8;
     class blast_variable
     {
     private:
@@ -27,8 +28,13 @@ namespace ismt
         Integer             curValue;
         std::vector<int>    data;
         std::string         name;
+        unsigned            id = 0; // of an anonymous inner variable
+        // the interval of its values, when tighter than its width
+        Integer             lower;
+        Integer             upper;
     public:
         blast_variable(const std::string& n, unsigned len, Integer v=0, bool isc=false){
+            info = 0;
             setName(n);
             setSize(len); 
             setCurValue(v);
@@ -42,11 +48,16 @@ namespace ismt
         bool        isConstant()        const { return info & mask_constant; }
         bool        isClean()           const { return info & mask_clear; }
         bool        hasZero()           const { return info & mask_zero; }
+        bool        hasRange()          const { return info & mask_range; }
+        const Integer& getLower()       const { return lower; }
+        const Integer& getUpper()       const { return upper; }
         unsigned    size()              const { return data.size(); }
         unsigned    csize()             const { return data.size()-1; } // content size
         Integer     getCurValue()       const { return curValue; }
         int         getAt(unsigned i)   const { return data[i]; }
-        std::string getName()           const { return name; }
+        // inner variables have no name, one is made for debugging.
+        std::string getName()           const { return id==0?name:"aux!"+std::to_string(id); }
+        unsigned    getId()             const { return id; }
 
         // setter
         void        setKind(bool isc)               { if(isc) info |= mask_constant; else info &= ~mask_constant; }
@@ -56,10 +67,20 @@ namespace ismt
         void        setName(const std::string& n)   { name = n; }
         void        setZero()                       { info |= mask_zero; }
         void        unsetZero()                     { info &= ~mask_zero; }
+        void        setRange(const Integer& l, const Integer& u){ lower = l; upper = u; info |= mask_range; }
 
         // friend operations
-        void        reblast()                       { info &= ~mask_clear; }
-        void        clear()                         { data.clear(); info |= mask_clear; } // NEW
+        // reuse of a pooled variable, keeps the capacity of data
+        void        recycle(unsigned i, unsigned len){
+            info = 0;
+            id = i;
+            data.clear();
+            setSize(len);
+            setCurValue(0);
+            setZero();
+        }
+        void        reblast()                       { info &= ~(mask_clear | mask_range); }
+        void        clear()                         { data.clear(); info |= mask_clear; info &= ~mask_range; } // NEW
         // when staying at formula tree, once restart this of variable kind can be clear. 
 
     };
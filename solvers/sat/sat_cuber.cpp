@@ -0,0 +1,229 @@
+/* sat_cuber.cpp
+*
+*  Copyright (C) 2023-2026 Fuqi Jia.
+*
+*  All rights reserved.
+*/
+
+#include "solvers/sat/sat_cuber.hpp"
+#include <thread>
+
+using namespace ismt;
+#define cubeDebug 0
+
+sat_cuber::sat_cuber(unsigned n): threads(n), stop(false), pending(0){
+    for(unsigned i=0;i<threads;i++){
+        cube_worker* w = new cube_worker();
+        w->terminator.stop = &stop;
+        w->learner.exchange = &exchange;
+        w->learner.producer = i;
+        workers.emplace_back(w);
+    }
+}
+sat_cuber::~sat_cuber(){
+    for(size_t i=0;i<workers.size();i++){
+        delete workers[i]->solver;
+        delete workers[i]; workers[i] = nullptr;
+    }
+}
+void sat_cuber::setTerminator(const std::atomic<bool>* f){
+    flag = f;
+    for(size_t i=0;i<workers.size();i++){
+        workers[i]->terminator.flag = f;
+    }
+}
+void sat_cuber::setDeadline(deadline* dl){
+    for(size_t i=0;i<workers.size();i++){
+        workers[i]->terminator.dl = dl;
+    }
+}
+// drop the solvers and the cnf.
+void sat_cuber::reset(){
+    for(size_t i=0;i<workers.size();i++){
+        delete workers[i]->solver; workers[i]->solver = nullptr;
+        workers[i]->loaded = 0;
+        workers[i]->cubes.clear();
+        // the clauses of the old cnf are dropped
+        workers[i]->cursor = exchange.end();
+    }
+    cnf.clear();
+    values.clear();
+    core.clear();
+    result = 0;
+}
+
+int sat_cuber::val(int lit) const{
+    int v = lit>0?lit:-lit;
+    if((size_t)v >= values.size()) return -lit;
+    return (values[v]>0) == (lit>0) ? lit : -lit;
+}
+bool sat_cuber::failed(int lit) const{
+    return core.find(lit) != core.end();
+}
+
+// own cubes from the back, stolen ones from the front.
+bool sat_cuber::pop(unsigned idx, literals& cube){
+    for(unsigned i=0;i<threads;i++){
+        cube_worker* w = workers[(idx + i) % threads];
+        std::lock_guard<std::mutex> lock(w->mtx);
+        if(w->cubes.empty()) continue;
+        if(i==0){
+            cube = w->cubes.back();
+            w->cubes.pop_back();
+        }
+        else{
+            cube = w->cubes.front();
+            w->cubes.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+void sat_cuber::push(unsigned idx, const literals& cube){
+    cube_worker* w = workers[idx];
+    {
+        std::lock_guard<std::mutex> lock(w->mtx);
+        w->cubes.emplace_back(cube);
+    }
+    wake();
+}
+void sat_cuber::wake(){
+    {
+        std::lock_guard<std::mutex> lock(idle_mtx);
+        ++events;
+    }
+    idle.notify_all();
+}
+
+void sat_cuber::work(unsigned idx, const literals& assumptions, const literals& splits, unsigned vars){
+    cube_worker* w = workers[idx];
+    if(w->solver == nullptr){
+        w->solver = new CaDiCaL::Solver();
+        w->solver->connect_terminator(&w->terminator);
+        w->solver->connect_learner(&w->learner);
+    }
+    // the clauses added since the last call
+    for(size_t i=w->loaded;i<cnf.size();i++){
+        w->solver->add(cnf[i]);
+    }
+    w->loaded = cnf.size();
+
+    literals cube;
+    std::vector<literals> clauses;
+    while(!stop){
+        unsigned long seen = 0;
+        {
+            std::lock_guard<std::mutex> lock(idle_mtx);
+            seen = events;
+        }
+        if(!pop(idx, cube)){
+            if(pending == 0) break;
+            // a cube is still solved by another worker, wait for its outcome.
+            std::unique_lock<std::mutex> lock(idle_mtx);
+            idle.wait(lock, [&]{ return stop || pending == 0 || events != seen; });
+            continue;
+        }
+        clauses.clear();
+        exchange.pull(idx, 0, w->cursor, clauses);
+        for(size_t i=0;i<clauses.size();i++){
+            for(size_t j=0;j<clauses[i].size();j++) w->solver->add(clauses[i][j]);
+            w->solver->add(0);
+        }
+        for(size_t i=0;i<assumptions.size();i++) w->solver->assume(assumptions[i]);
+        for(size_t i=0;i<cube.size();i++) w->solver->assume(cube[i]);
+        // -CL bounds each cube, a cube spending it gives up the call.
+        int budget = (w->terminator.dl != nullptr && w->terminator.dl->conflicts > 0) ? w->terminator.dl->conflicts : 0;
+        bool limited = cube.size() < splits.size() && (budget == 0 || conflicts < budget);
+        if(limited) w->solver->limit("conflicts", conflicts);
+        else if(budget > 0) w->solver->limit("conflicts", budget);
+        int ans = w->solver->solve();
+        if(ans == 10){
+            std::lock_guard<std::mutex> lock(mtx);
+            if(result != 10){
+                result = 10;
+                values.assign(vars, 0);
+                for(unsigned i=1;i<vars;i++){
+                    values[i] = w->solver->val(i)>0?1:-1;
+                }
+            }
+            stop = true;
+            wake();
+        }
+        else if(ans == 20){
+            // the failed assumptions of the cube, refuting the base when no
+            // cube literal is used.
+            bool base = true;
+            for(size_t i=0;i<cube.size();i++){
+                if(w->solver->failed(cube[i])){ base = false; break; }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                for(size_t i=0;i<assumptions.size();i++){
+                    if(w->solver->failed(assumptions[i])) core.insert(assumptions[i]);
+                }
+                if(base){
+                    if(result != 10) result = 20;
+                    stop = true;
+                }
+                --pending;
+            }
+            wake();
+        }
+        else if(limited && !w->terminator.terminate()){
+            // a hard cube, split on the next literal.
+            literal split = splits[cube.size()];
+            ++pending;
+            cube.emplace_back(-split);
+            push(idx, cube);
+            cube.back() = split;
+            push(idx, cube);
+            #if cubeDebug
+                std::cout<<"split cube at depth "<<cube.size()<<std::endl;
+            #endif
+        }
+        else{
+            // cancelled or out of conflicts, the others stop as well.
+            stop = true;
+            wake();
+            break;
+        }
+    }
+}
+
+int sat_cuber::solve(const literals& assumptions, const literals& splits, unsigned vars){
+    result = 0;
+    values.clear();
+    core.clear();
+    stop = false;
+
+    // 2^depth cubes, a few per worker
+    unsigned depth = 2;
+    while((1u << depth) < threads * 4) ++depth;
+    if(depth > splits.size()) depth = splits.size();
+    for(size_t i=0;i<workers.size();i++) workers[i]->cubes.clear();
+    for(unsigned c=0;c<(1u << depth);c++){
+        literals cube;
+        for(unsigned i=0;i<depth;i++){
+            cube.emplace_back((c >> i) & 1 ? splits[i] : -splits[i]);
+        }
+        workers[c % threads]->cubes.emplace_back(cube);
+    }
+    pending = 1 << depth;
+
+    std::vector<std::thread> pool;
+    for(unsigned i=0;i<threads;i++){
+        pool.emplace_back(&sat_cuber::work, this, i, std::cref(assumptions), std::cref(splits), vars);
+    }
+    for(size_t i=0;i<pool.size();i++){
+        pool[i].join();
+    }
+
+    if(result == 10) return 10;
+    // every cube is refuted or a base refutation was found.
+    if(result == 20 || pending == 0){
+        result = 20;
+        return 20;
+    }
+    core.clear();
+    return 0;
+}
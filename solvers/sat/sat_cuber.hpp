@@ -0,0 +1,104 @@
+/* sat_cuber.hpp
+*
+*  Copyright (C) 2023-2026 Fuqi Jia.
+*
+*  All rights reserved.
+*/
+
+#ifndef _SAT_CUBER_H
+#define _SAT_CUBER_H
+
+#include "utils/types.hpp"
+#include "solvers/sat/sat_types.hpp"
+#include "solvers/sat/sat_exchange.hpp"
+#include "utils/deadline.hpp"
+
+// only cadical
+#include "solvers/include/cadical.hpp"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <boost/unordered_set.hpp>
+
+namespace ismt
+{
+    // stops a cube once the cuber or the caller gives up.
+    class cube_terminator : public CaDiCaL::Terminator
+    {
+    public:
+        const std::atomic<bool>* flag = nullptr;
+        const std::atomic<bool>* stop = nullptr;
+        deadline* dl = nullptr;
+        bool terminate(){
+            return  (flag != nullptr && flag->load(std::memory_order_relaxed)) ||
+                    (stop != nullptr && stop->load(std::memory_order_relaxed)) ||
+                    (dl != nullptr && dl->poll());
+        }
+    };
+
+    // an incremental solver of the pool with its own cubes.
+    struct cube_worker{
+        CaDiCaL::Solver*        solver = nullptr;
+        size_t                  loaded = 0; // prefix of the cnf added to the solver
+        cube_terminator         terminator;
+        sat_learner             learner;
+        unsigned long           cursor = 0; // of the exchange
+        std::deque<literals>    cubes;
+        std::mutex              mtx;
+    };
+
+    // cube-and-conquer: the cubes are assignments to a prefix of the split
+    // literals, solved as assumptions by a pool of solvers over the same cnf.
+    // a cube running out of conflicts is split on the next literal, the idle
+    // workers steal cubes from the others, and the workers exchange their
+    // short learnt clauses before each cube.
+    class sat_cuber
+    {
+    private:
+        unsigned                    threads;
+        std::vector<cube_worker*>   workers;
+        // the workers share one cnf, so the learnt clauses need no mapping.
+        sat_exchange                exchange;
+        const std::atomic<bool>*    flag = nullptr;
+
+        // search state
+        std::atomic<bool>           stop;
+        std::atomic<int>            pending;
+        std::mutex                  mtx;
+        // the idle workers sleep until a cube is pushed, one is done or the search stops.
+        std::mutex                  idle_mtx;
+        std::condition_variable     idle;
+        unsigned long               events = 0;
+        int                         result = 0;
+        std::vector<int>            values;
+        boost::unordered_set<int>   core;
+
+        bool pop    (unsigned idx, literals& cube);
+        void push   (unsigned idx, const literals& cube);
+        void wake   ();
+        void work   (unsigned idx, const literals& assumptions, const literals& splits, unsigned vars);
+    public:
+        // the clauses of the base cnf, each ended by 0.
+        std::vector<literal>        cnf;
+        // conflicts of a cube before it is split.
+        int                         conflicts = 10000;
+
+        sat_cuber(unsigned n);
+        ~sat_cuber();
+
+        // 10 sat, 20 unsat, 0 unknown as cadical.
+        int  solve          (const literals& assumptions, const literals& splits, unsigned vars);
+        int  val            (int lit) const;
+        bool failed         (int lit) const;
+        void setTerminator  (const std::atomic<bool>* f);
+        void setDeadline    (deadline* dl);
+        void reset          ();
+    };
+
+} // namespace ismt
+
+
+#endif
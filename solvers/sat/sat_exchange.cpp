@@ -0,0 +1,95 @@
+/* sat_exchange.cpp
+*
+*  Copyright (C) 2023-2026 Fuqi Jia.
+*
+*  All rights reserved.
+*/
+
+#include "solvers/sat/sat_exchange.hpp"
+
+using namespace ismt;
+
+sat_exchange::sat_exchange(unsigned cap): capacity(cap), head(0){
+    ring = new slot[capacity];
+}
+sat_exchange::~sat_exchange(){
+    delete [] ring; ring = nullptr;
+}
+
+int sat_exchange::id(const void* node, int bit){
+    std::lock_guard<std::mutex> lock(mtx);
+    std::pair<const void*, int> key(node, bit);
+    auto it = ids.find(key);
+    if(it != ids.end()) return it->second;
+    int g = ids.size() + 1;
+    ids.insert(std::pair<std::pair<const void*, int>, int>(key, g));
+    return g;
+}
+
+// seq is 2*pos+1 while the slot is written and 2*pos+2 once it is published.
+// a seqlock writer: the odd seq, a release fence, the data, the even seq.
+void sat_exchange::push(int producer, int stamp, const literals& lits){
+    if(lits.size() == 0 || lits.size() > max_size) return;
+    unsigned long pos = head.fetch_add(1);
+    slot& s = ring[pos % capacity];
+    // claim the slot from its publication of the lap before. a writer a lap
+    // away still on it keeps it, and the clause is dropped.
+    unsigned long prev = pos < capacity ? 0 : 2*(pos-capacity)+2;
+    if(!s.seq.compare_exchange_strong(prev, 2*pos+1, std::memory_order_relaxed)) return;
+    std::atomic_thread_fence(std::memory_order_release);
+    s.producer.store(producer, std::memory_order_relaxed);
+    s.stamp.store(stamp, std::memory_order_relaxed);
+    s.size.store(lits.size(), std::memory_order_relaxed);
+    for(size_t i=0;i<lits.size();i++){
+        s.lits[i].store(lits[i], std::memory_order_relaxed);
+    }
+    s.seq.store(2*pos+2, std::memory_order_release);
+}
+
+void sat_exchange::pull(int consumer, int stamp, unsigned long& cursor, std::vector<literals>& clauses){
+    unsigned long end = head.load(std::memory_order_acquire);
+    // the slots before end - capacity are overwritten
+    if(end > capacity && cursor < end - capacity) cursor = end - capacity;
+    literals lits;
+    for(;cursor<end;cursor++){
+        slot& s = ring[cursor % capacity];
+        unsigned long seq = s.seq.load(std::memory_order_acquire);
+        // not published yet, read it next time
+        if(seq < 2*cursor+2) break;
+        if(seq != 2*cursor+2) continue;
+        int producer = s.producer.load(std::memory_order_relaxed);
+        int from = s.stamp.load(std::memory_order_relaxed);
+        int size = s.size.load(std::memory_order_relaxed);
+        lits.clear();
+        for(int i=0;i<size && i<(int)max_size;i++){
+            lits.emplace_back(s.lits[i].load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // overwritten while reading
+        if(s.seq.load(std::memory_order_relaxed) != seq) continue;
+        if(producer == consumer || from < stamp) continue;
+        clauses.emplace_back(lits);
+    }
+}
+
+unsigned long sat_exchange::end() const{
+    return head.load(std::memory_order_acquire);
+}
+
+void sat_learner::learn(int lit){
+    if(lit != 0){
+        if(!ok) return;
+        if(l2g == nullptr){
+            clause.emplace_back(lit);
+            return;
+        }
+        int v = lit>0?lit:-lit;
+        int g = v<(int)l2g->size()?(*l2g)[v]:0;
+        if(g == 0) ok = false;
+        else clause.emplace_back(lit>0?g:-g);
+        return;
+    }
+    if(ok) exchange->push(producer, stamp, clause);
+    clause.clear();
+    ok = true;
+}
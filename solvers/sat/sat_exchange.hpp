@@ -0,0 +1,77 @@
+/* sat_exchange.hpp
+*
+*  Copyright (C) 2023-2026 Fuqi Jia.
+*
+*  All rights reserved.
+*/
+
+#ifndef _SAT_EXCHANGE_H
+#define _SAT_EXCHANGE_H
+
+#include "utils/types.hpp"
+#include "solvers/sat/sat_types.hpp"
+
+// only cadical
+#include "solvers/include/cadical.hpp"
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <boost/unordered_map.hpp>
+
+namespace ismt
+{
+    // short learnt clauses shared by the solvers of a group, over global ids.
+    // a ring buffer: the writers claim a slot and publish it by its sequence,
+    // the readers keep their own cursor and skip overwritten slots.
+    class sat_exchange
+    {
+    public:
+        static const unsigned max_size = 2;
+    private:
+        struct slot{
+            std::atomic<unsigned long>  seq;
+            std::atomic<int>            producer;
+            std::atomic<int>            stamp;
+            std::atomic<int>            size;
+            std::atomic<int>            lits[max_size];
+            slot(): seq(0), producer(-1), stamp(0), size(0){}
+        };
+        unsigned                    capacity;
+        slot*                       ring = nullptr;
+        std::atomic<unsigned long>  head;
+
+        // (node, bit) -> global id, registered while blasting
+        std::mutex                  mtx;
+        boost::unordered_map<std::pair<const void*, int>, int> ids;
+    public:
+        sat_exchange(unsigned cap = 1 << 14);
+        ~sat_exchange();
+
+        int  id     (const void* node, int bit);
+        void push   (int producer, int stamp, const literals& lits);
+        // the clauses of the others after cursor, learnt from a stamp no less than stamp.
+        void pull   (int consumer, int stamp, unsigned long& cursor, std::vector<literals>& clauses);
+        unsigned long end() const;
+    };
+
+    // exports the short learnt clauses of a solver, mapped to global ids.
+    class sat_learner : public CaDiCaL::Learner
+    {
+    public:
+        sat_exchange*               exchange = nullptr;
+        int                         producer = 0;
+        int                         stamp = 0;
+        const std::vector<int>*     l2g = nullptr; // local var -> global literal, identity if null
+        literals                    clause;
+        bool                        ok = true;
+
+        bool learning(int size){ return exchange != nullptr && size <= (int)sat_exchange::max_size; }
+        void learn(int lit);
+    };
+
+} // namespace ismt
+
+
+#endif
@@ -7,6 +7,7 @@
 
 #include "solvers/sat/sat_solver.hpp"
 #include <iostream>
+#include <algorithm>
 
 using namespace ismt;
 #define printClauses 0
@@ -22,9 +23,13 @@ sat_solver::sat_solver(std::string n){
 sat_solver::~sat_solver(){
     delete solver;
     solver = nullptr;
+    delete cuber;
+    cuber = nullptr;
 }
 void sat_solver::setConst(){
     solver->set("log", 1);
+    solver->connect_terminator(&terminator);
+    if(learner.exchange != nullptr) solver->connect_learner(&learner);
     SAT_False = 1, SAT_True = 2, iVars = 3;
     // false literal
     solver->add(-1);
@@ -33,6 +38,9 @@ void sat_solver::setConst(){
     solver->add(2);
     solver->add(0);
     iClauses = 2;
+    if(cuber != nullptr){
+        cuber->cnf.insert(cuber->cnf.end(), {-1, 0, 2, 0});
+    }
 }
 bool_var sat_solver::False() const {
     return SAT_False;
@@ -53,6 +61,10 @@ int sat_solver::nClauses() const{
     return iClauses;
 }
 
+int64_t sat_solver::statistic(const char* name) const{
+    return solver->get_statistic_value(name);
+}
+
 // add to solver
 int sat_solver::newVar(){
     return iVars++;
@@ -62,21 +74,32 @@ int sat_solver::newVars(unsigned num){
     return iVars;
 }
 bool sat_solver::addClause(clause& c){
+    return addClause(c.data(), c.size());
+}
+bool sat_solver::addClause(const literal* lits, unsigned n){
     
     #if printClauses
         std::cout<<"add clause: ";
-        for(size_t i=0;i<c.size();i++){
-            std::cout<<c[i]<<" ";
+        for(unsigned i=0;i<n;i++){
+            std::cout<<lits[i]<<" ";
         }
         std::cout<<"0"<<std::endl;
     #endif
 
-    for(size_t i = 0;i<c.size();i++){
-        solver->add(c[i]);
+    ++iClauses;
+    // cubing: every solve goes through the cuber, so the cnf is kept once
+    // for its workers and not in the solver as well.
+    if(cuber != nullptr){
+        cuber->cnf.insert(cuber->cnf.end(), lits, lits + n);
+        cuber->cnf.emplace_back(0);
+        return true;
+    }
+
+    for(unsigned i=0;i<n;i++){
+        solver->add(lits[i]);
     }
     solver->add(0);
-    ++iClauses;
-    
+
     return true;
 }
 
@@ -84,20 +107,63 @@ bool sat_solver::addClause(clause& c){
 bool sat_solver::simplify(const literals& c){
     return solve(c);
 }
+// solve in chunks, importing the clauses of the others in between.
+int sat_solver::chunked(const literals& aps){
+    int ans = 0;
+    int remaining = terminator.dl != nullptr ? terminator.dl->conflicts : 0;
+    while(true){
+        import();
+        for(size_t i=0;i<aps.size();i++) solver->assume(aps[i]);
+        int limit = chunk;
+        if(remaining > 0){
+            limit = std::min(limit, remaining);
+            remaining -= limit;
+        }
+        solver->limit("conflicts", limit);
+        ans = solver->solve();
+        if(ans != 0 || terminator.terminate()) break;
+        // the conflicts of the call are spent
+        if(terminator.dl != nullptr && terminator.dl->conflicts > 0 && remaining == 0) break;
+    }
+    return ans;
+}
 bool sat_solver::solve(){
-    int ans = solver->solve();
+    if(cuber != nullptr) return solve(literals(), literals());
+    cubed = false;
+    if(learner.exchange == nullptr && terminator.dl != nullptr && terminator.dl->conflicts > 0){
+        solver->limit("conflicts", terminator.dl->conflicts);
+    }
+    int ans = learner.exchange != nullptr ? chunked(literals()) : solver->solve();
     if(ans==10) state = State::SAT;
     else if(ans==20) state = State::UNSAT;
     else state = State::UNKNOWN;
     return true;
 }
 bool sat_solver::solve(const literals& aps){
+    if(cuber != nullptr) return solve(aps, literals());
     assumptions.clear();
     for(size_t i=0;i<aps.size();i++){
         assumptions.emplace_back(aps[i]);
-        solver->assume(aps[i]);
+        if(learner.exchange == nullptr) solver->assume(aps[i]);
     }
-    return solve();
+    if(learner.exchange == nullptr) return solve();
+    cubed = false;
+    int ans = chunked(aps);
+    if(ans==10) state = State::SAT;
+    else if(ans==20) state = State::UNSAT;
+    else state = State::UNKNOWN;
+    return true;
+}
+bool sat_solver::solve(const literals& aps, const literals& splits){
+    // without splits the cuber solves the one empty cube.
+    if(cuber == nullptr) return solve(aps);
+    assumptions.assign(aps.begin(), aps.end());
+    cubed = true;
+    int ans = cuber->solve(aps, splits, iVars);
+    if(ans==10) state = State::SAT;
+    else if(ans==20) state = State::UNSAT;
+    else state = State::UNKNOWN;
+    return true;
 }
 
 // state
@@ -112,7 +178,7 @@ model sat_solver::getModel(){
     if(state==State::SAT){
         t.emplace_back(0); // place holder for index of 0
         for(unsigned i=1;i<iVars;i++){
-            t.emplace_back(solver->val(i)>0?1:0);
+            t.emplace_back(val(i)>0?1:0);
             #if printModel
                 std::cout<<i<<": "<<t[i]<<std::endl;
             #endif
@@ -133,6 +199,11 @@ model sat_solver::getModel(){
 void sat_solver::reset(){
     delete solver; solver = nullptr;
     solver = new CaDiCaL::Solver();
+    cubed = false;
+    l2g.clear();
+    g2l.clear();
+    cursor = 0; // the new solver imports the clauses still in the exchange
+    if(cuber != nullptr) cuber->reset();
     setConst();
 }
 
@@ -143,6 +214,66 @@ void sat_solver::setBenchmark(std::string file){
 }
 
 
+void sat_solver::setTerminator(const std::atomic<bool>* flag){
+    terminator.flag = flag;
+    if(cuber != nullptr) cuber->setTerminator(flag);
+}
+void sat_solver::setDeadline(deadline* dl){
+    terminator.dl = dl;
+    if(cuber != nullptr) cuber->setDeadline(dl);
+}
+void sat_solver::setCubes(unsigned n){
+    if(n <= 1 || cuber != nullptr) return;
+    // the cnf is logged from the start, set before any clause.
+    cuber = new sat_cuber(n);
+    cuber->cnf.insert(cuber->cnf.end(), {-1, 0, 2, 0});
+    cuber->setTerminator(terminator.flag);
+    cuber->setDeadline(terminator.dl);
+}
+bool sat_solver::cubing() const{
+    return cuber != nullptr;
+}
+void sat_solver::setExchange(sat_exchange* e, int id){
+    learner.exchange = e;
+    learner.producer = id;
+    learner.l2g = &l2g;
+    if(e != nullptr) solver->connect_learner(&learner);
+    else solver->disconnect_learner();
+}
+bool sat_solver::sharing() const{
+    return learner.exchange != nullptr;
+}
+void sat_solver::share(int lit, const void* node, int bit){
+    int v = lit>0?lit:-lit;
+    if(v == SAT_True || v == SAT_False) return;
+    if(v < (int)l2g.size() && l2g[v] != 0) return;
+    int g = learner.exchange->id(node, bit);
+    if(g2l.find(g) != g2l.end()) return;
+    if(v >= (int)l2g.size()) l2g.resize(v+1, 0);
+    l2g[v] = lit>0?g:-g;
+    g2l.insert(std::pair<int, int>(g, lit>0?v:-v));
+}
+void sat_solver::setStamp(int stamp){
+    learner.stamp = stamp;
+}
+void sat_solver::import(){
+    std::vector<literals> clauses;
+    learner.exchange->pull(learner.producer, learner.stamp, cursor, clauses);
+    for(size_t i=0;i<clauses.size();i++){
+        clause c;
+        for(size_t j=0;j<clauses[i].size();j++){
+            int g = clauses[i][j];
+            auto it = g2l.find(g>0?g:-g);
+            if(it == g2l.end()) break;
+            c.emplace_back(g>0?it->second:-it->second);
+        }
+        if(c.size() != clauses[i].size()) continue;
+        for(size_t j=0;j<c.size();j++) solver->add(c[j]);
+        solver->add(0);
+    }
+}
+
+
 // cdcl(t) function
 bool sat_solver::propagate(){
     solver->limit("decisions", 0);
@@ -160,13 +291,14 @@ void sat_solver::partial(boost::unordered_map<int, int>& m){
     }
 }
 int sat_solver::val(int lit){
+    if(cubed) return cuber->val(lit);
     return solver->val(lit);
 }
 
 // get unsat assumptions
 void sat_solver::getConflict(literals& aps){
     for(size_t i=0;i<assumptions.size();i++){
-        if(solver->failed(assumptions[i])){
+        if(cubed ? cuber->failed(assumptions[i]) : solver->failed(assumptions[i])){
             aps.emplace_back(assumptions[i]);
         }
     }
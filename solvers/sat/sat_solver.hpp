@@ -11,6 +11,9 @@
 #include "utils/types.hpp"
 #include "frontend/dag.hpp"
 #include "solvers/sat/sat_types.hpp"
+#include "solvers/sat/sat_cuber.hpp"
+#include "solvers/sat/sat_exchange.hpp"
+#include "utils/deadline.hpp"
 
 // only cadical
 #include "solvers/include/cadical.hpp"
@@ -18,9 +21,23 @@
 
 #include<string>
 #include<vector>
+#include<atomic>
 
 namespace ismt
 {
+    // stops a running search once the flag is raised by another thread,
+    // or the budget of the run is spent.
+    class sat_terminator : public CaDiCaL::Terminator
+    {
+    public:
+        const std::atomic<bool>* flag = nullptr;
+        deadline* dl = nullptr;
+        bool terminate(){
+            return  (flag != nullptr && flag->load(std::memory_order_relaxed)) ||
+                    (dl != nullptr && dl->poll());
+        }
+    };
+
     class sat_solver
     {
     private:
@@ -41,6 +58,22 @@ namespace ismt
         // cdcl(t)
         literals            assumptions;
 
+        // cancellation
+        sat_terminator      terminator;
+
+        // cube-and-conquer, the last solve went through the cuber
+        sat_cuber*          cuber = nullptr;
+        bool                cubed = false;
+
+        // clause sharing: local var <-> global id of the exchange
+        sat_learner         learner;
+        std::vector<int>    l2g;
+        boost::unordered_map<int, int> g2l;
+        unsigned long       cursor = 0;
+        int                 chunk = 10000; // conflicts between imports
+        void        import();
+        int         chunked(const literals& aps);
+
         // inner functions
         void setConst();
     public:
@@ -54,6 +87,8 @@ namespace ismt
         // number of vars
         int         nVars() const;
         int         nClauses() const;
+        // statistics of cadical, e.g. conflicts, decisions, propagations
+        int64_t     statistic(const char* name) const;
 
 
         // idx of current variables
@@ -63,11 +98,13 @@ namespace ismt
         int         newVar();
         int         newVars(unsigned num);
         bool        addClause(clause& c);
+        bool        addClause(const literal* lits, unsigned n); // streamed to the solver as is
         
         // solve
         bool        simplify(const literals& c); // means simple solve
         bool        solve();
         bool        solve(const literals& aps);
+        bool        solve(const literals& aps, const literals& splits); // cube on the splits
 
         // state
         State       getState() const;
@@ -80,6 +117,21 @@ namespace ismt
 
         // benchmark setting
         void        setBenchmark(std::string file);
+
+        // cancel the search when flag is raised
+        void        setTerminator(const std::atomic<bool>* flag);
+        // the budget of the run, with the conflicts of each call
+        void        setDeadline(deadline* dl);
+
+        // solve by cube-and-conquer with n threads
+        void        setCubes(unsigned n);
+        bool        cubing() const;
+
+        // share the short learnt clauses with the group of the exchange
+        void        setExchange(sat_exchange* e, int id);
+        bool        sharing() const;
+        void        share(int lit, const void* node, int bit); // lit is the bit of node.
+        void        setStamp(int stamp); // the clauses are valid for stamps up to it.
         
         // cdcl(t) function
         bool        propagate();
@@ -0,0 +1,15 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: constant multiplication of terms that fold to constants or to one bit|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 6)) (<= x 6) (>= y (- 6)) (<= y 6) (distinct y 0)))
+(assert (or (distinct (* (- 2) (abs (ite (> x 0) 1 (- 1)))) (- 2))
+            (distinct (* (- 2) (div y y)) (- 2))
+            (distinct (* 6 (div y y)) 6)
+            (distinct (* 6 (ite (> x 0) 1 (- 1))) (ite (> x 0) 6 (- 6)))
+            (distinct (* (- 3) (ite (> x 0) 1 (- 1))) (ite (> x 0) (- 3) 3))))
+(check-sat)
+(exit)
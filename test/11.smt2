@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: div and mod by zero are unspecified, any value is a model|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x 0) (<= x 3) (>= y 0) (<= y 3)))
+(assert (= (div x 0) 100))
+(assert (= (mod x 0) (- 7)))
+(assert (= (div 5 0) (- 9)))
+(assert (= (+ (div y 0) (mod 0 0)) (* x y 5)))
+(check-sat)
+(exit)
@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: incremental widening over several rounds, with a bounded variable declared in each|)
+(set-info :category "crafted")
+(set-info :status sat)
+; options: -IW:true
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (and (>= z 0) (<= z 5)))
+(assert (and (> x 1000) (> y 1000)))
+(assert (= (* x y) (+ 1022114 z)))
+(check-sat)
+(exit)
@@ -0,0 +1,15 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: core-guided widening of some variables, the others declared again with their bounds|)
+(set-info :category "crafted")
+(set-info :status sat)
+; options: -CG:true
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (and (>= z 1) (<= z 5)))
+(assert (= (* x z) 3027))
+(assert (= (+ x y) 1000))
+(assert (< (* y z) 0))
+(check-sat)
+(exit)
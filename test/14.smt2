@@ -0,0 +1,13 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: an unsat core of bounded variables only is unsat at any width|)
+(set-info :category "crafted")
+(set-info :status unsat)
+; options: -IW:true
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x 0) (<= x 20)))
+(assert (= (* x x) 7))
+(assert (> (* x y) 5))
+(check-sat)
+(exit)
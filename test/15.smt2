@@ -0,0 +1,12 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: a portfolio of configurations on threads agrees on the answer|)
+(set-info :category "crafted")
+(set-info :status sat)
+; options: -P:4
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (> x 100) (> y 100) (> x y)))
+(assert (= (* x y) 10403))
+(check-sat)
+(exit)
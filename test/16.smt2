@@ -0,0 +1,13 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: racing consecutive widths, the answer is found at the widest|)
+(set-info :category "crafted")
+(set-info :status sat)
+; options: -WR:3
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (> x 0))
+(assert (= (* x x x) (+ 1030300 y)))
+(assert (= (* y y) 1))
+(check-sat)
+(exit)
@@ -0,0 +1,12 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: cube-and-conquer refutes every cube of a prime factoring|)
+(set-info :category "crafted")
+(set-info :status unsat)
+; options: -CC:4
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x 2) (<= x 200) (>= y 2) (<= y 200)))
+(assert (= (* x y) 10007))
+(check-sat)
+(exit)
@@ -0,0 +1,19 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: squares, cubes and products of mixed signs in a wallace tree|)
+(set-info :category "crafted")
+(set-info :status unsat)
+; options: -MUL:wallace
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 12)) (<= x 12) (>= y (- 12)) (<= y 12)))
+(assert (or (< (* x x) 0)
+            (and (= (* x x) 144) (distinct x 12) (distinct x (- 12)))
+            (and (= (* x x) 0) (distinct x 0))
+            (and (= (* x x x) (- 1331)) (distinct x (- 11)))
+            (and (= (* x x x x) 81) (> (abs x) 3))
+            (> (* x y) 144)
+            (< (* x y) (- 144))
+            (and (= (* x y) (- 132)) (distinct (+ x y) 1) (distinct (+ x y) (- 1)))))
+(check-sat)
+(exit)
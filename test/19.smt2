@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: a negative cube and a square in a dadda tree|)
+(set-info :category "crafted")
+(set-info :status sat)
+; options: -MUL:dadda
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 20)) (<= x 20) (>= y (- 20)) (<= y 20)))
+(assert (= (* x x x) (- 1331)))
+(assert (= (* y y) 144))
+(assert (< (* x y) 0))
+(check-sat)
+(exit)
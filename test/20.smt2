@@ -0,0 +1,17 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: products by constants in non-adjacent form, odd, negative and powers of two|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(assert (and (>= x (- 40)) (<= x 40)))
+(assert (or (> (* 1023 x) 40920)
+            (< (* 1023 x) (- 40920))
+            (and (> x 0) (>= (* (- 7) x) 0))
+            (and (= (* 7 x) (- 273)) (distinct x (- 39)))
+            (and (= (* 11 x) 440) (distinct x 40))
+            (and (= (* (- 255) x) (- 255)) (distinct x 1))
+            (and (= (* 15 x) (- 600)) (distinct x (- 40)))
+            (and (= (* (- 128) x) 5120) (distinct x (- 40)))))
+(check-sat)
+(exit)
@@ -0,0 +1,16 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: n-ary sums of products at the ends of their range|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (and (>= x (- 8)) (<= x 7) (>= y (- 8)) (<= y 7) (>= z (- 8)) (<= z 7)))
+(assert (or (> (+ x y z (* x y) (* y z)) 119)
+            (< (+ x y z (* x y) (* y z)) (- 121))
+            (and (= (+ x y z (* x y) (* y z)) (- 121)) (distinct y 7))
+            (and (= (+ x y z x y) 35) (distinct x 7))
+            (and (= (+ x y z) (- 24)) (distinct z (- 8)))))
+(check-sat)
+(exit)
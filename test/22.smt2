@@ -0,0 +1,12 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: an n-ary sum of products at its least value|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (and (>= x (- 8)) (<= x 7) (>= y (- 8)) (<= y 7) (>= z (- 8)) (<= z 7)))
+(assert (= (+ x y z (* x y) (* y z)) (- 121)))
+(check-sat)
+(exit)
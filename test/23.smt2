@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: intermediate results sized by their interval, at its ends|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 128)) (<= x 127) (>= y 0) (<= y 3)))
+(assert (or (> (* x y) 381)
+            (< (* x y) (- 384))
+            (> (+ (* x y) (* x x)) 16765)
+            (and (= (* x y) (- 384)) (distinct x (- 128)))))
+(check-sat)
+(exit)
@@ -0,0 +1,12 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: intermediate results sized by their interval, the least product|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 128)) (<= x 127) (>= y 0) (<= y 3)))
+(assert (= (* x y) (- 384)))
+(assert (= (+ (* x x) y) 16387))
+(check-sat)
+(exit)
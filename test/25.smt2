@@ -0,0 +1,16 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: differences and products of non-negative variables|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x 0) (<= x 15) (>= y 0) (<= y 15)))
+(assert (or (> (- 0 x) 0)
+            (and (< (- x y) 0) (>= x y))
+            (> (- (* x y) (* x x)) 56)
+            (and (= (- (* x y) (* x x)) 56) (distinct y 15))
+            (< (- x y) (- 15))
+            (and (= (- x y) (- 15)) (distinct x 0))))
+(check-sat)
+(exit)
@@ -0,0 +1,12 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: a negative product of non-negative variables|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x 0) (<= x 15) (>= y 0) (<= y 15)))
+(assert (= (- x y) (- 15)))
+(assert (= (* (- x 15) y) (- 225)))
+(check-sat)
+(exit)
@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: atoms under negation, xor, implication and ite|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 10)) (<= x 10) (>= y (- 10)) (<= y 10)))
+(assert (or (not (=> (> x 0) (>= x 0)))
+            (xor (> x 0) (< (- x) 0))
+            (ite (> x 5) (< (* x x) 25) (> (* x x) 100))
+            (not (= (> (* x y) 0) (or (and (> x 0) (> y 0)) (and (< x 0) (< y 0)))))))
+(check-sat)
+(exit)
@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: atoms in both polarities through equivalence and xor|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 10)) (<= x 10) (>= y (- 10)) (<= y 10)))
+(assert (= (> x 0) (> y 0)))
+(assert (xor (> x y) (> y 0)))
+(assert (= (* x y) 12))
+(assert (distinct x y))
+(check-sat)
+(exit)
@@ -0,0 +1,16 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: a chain of equal variables and their equal atoms|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (and (>= x (- 9)) (<= x 9) (>= y (- 9)) (<= y 9) (>= z (- 9)) (<= z 9)))
+(assert (= x y))
+(assert (= y z))
+(assert (or (distinct (* x x) (* z z))
+            (distinct (> x 0) (> z 0))
+            (> (* x y) (* z z))))
+(check-sat)
+(exit)
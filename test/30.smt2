@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: opposite variables with equal atoms|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 9)) (<= x 9) (>= y (- 9)) (<= y 9)))
+(assert (= x (- y)))
+(assert (= (* x y) (- 49)))
+(assert (= (> x 0) (< y 0)))
+(assert (< x 0))
+(check-sat)
+(exit)
@@ -0,0 +1,15 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: ite and abs as multiplexers, at the least value|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 16)) (<= x 15) (>= y (- 16)) (<= y 15)))
+(assert (or (distinct (abs x) (ite (< x 0) (- x) x))
+            (< (abs x) 0)
+            (distinct (ite (> x y) x y) (ite (<= x y) y x))
+            (distinct (abs (* x y)) (* (abs x) (abs y)))
+            (> (- (abs x) (abs y)) (abs (- x y)))))
+(check-sat)
+(exit)
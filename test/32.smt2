@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: the abs of the least value needs one more bit|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 16)) (<= x 15) (>= y (- 16)) (<= y 15)))
+(assert (= (abs x) 16))
+(assert (< x 0))
+(assert (= (ite (> x y) x y) 15))
+(assert (= (abs (* x y)) 240))
+(check-sat)
+(exit)
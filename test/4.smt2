@@ -0,0 +1,15 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |factoring: a product of three primes and a product of two, a multiplication benchmark|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(declare-fun u () Int)
+(declare-fun v () Int)
+(assert (and (> x 1) (> y 1) (> z 1) (<= x y) (<= y z) (= (* x y z) 1009091)))
+(assert (and (> u 1) (> v 1) (<= u v) (= (* u v) 1022117)))
+(check-sat)
+;(get-model)
+(exit)
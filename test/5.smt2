@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: euclidean div and mod by a variable, negative dividends and divisors|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 9)) (<= x 9) (>= y (- 9)) (<= y 9) (distinct y 0)))
+(assert (or (< x 0) (< y 0)))
+(assert (or (< (mod x y) 0)
+            (>= (mod x y) (abs y))
+            (distinct x (+ (* y (div x y)) (mod x y)))))
+(check-sat)
+(exit)
@@ -0,0 +1,14 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: euclidean div and mod by constants, wider than a negative dividend as well|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(assert (and (>= x (- 20)) (<= x 20)))
+(assert (or (distinct x (+ (* 8 (div x 8)) (mod x 8))) (< (mod x 8) 0) (>= (mod x 8) 8)
+            (distinct x (+ (* (- 4) (div x (- 4))) (mod x (- 4)))) (< (mod x (- 4)) 0) (>= (mod x (- 4)) 4)
+            (distinct x (+ (* 6 (div x 6)) (mod x 6))) (< (mod x 6) 0) (>= (mod x 6) 6)
+            (distinct x (+ (* (- 3) (div x (- 3))) (mod x (- 3)))) (< (mod x (- 3)) 0) (>= (mod x (- 3)) 3)
+            (distinct x (+ (* 64 (div x 64)) (mod x 64))) (< (mod x 64) 0) (>= (mod x 64) 64)))
+(check-sat)
+(exit)
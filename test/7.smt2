@@ -0,0 +1,15 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: euclidean div and mod of constants, and of a negative dividend smaller than the divisor|)
+(set-info :category "crafted")
+(set-info :status sat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (= (div (- 7) 2) (- 4)) (= (mod (- 7) 2) 1)
+             (= (div 7 (- 2)) (- 3)) (= (mod 7 (- 2)) 1)
+             (= (div (- 7) (- 2)) 4) (= (mod (- 7) (- 2)) 1)))
+(assert (and (>= x (- 3)) (<= x (- 1)) (>= y 4) (<= y 5)))
+(assert (and (= (div x 8) (- 1)) (= (mod x 8) (+ x 8))))
+(assert (and (= (div x y) (- 1)) (= (mod x y) (+ x y))))
+(check-sat)
+(exit)
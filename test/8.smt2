@@ -0,0 +1,16 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: the recursion comparator on mixed signs and zero|)
+(set-info :category "crafted")
+(set-info :status unsat)
+; options: -CMP:recursion
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 8)) (<= x 8) (>= y (- 8)) (<= y 8)))
+(assert (or (and (< x 0) (>= y 0) (>= x y))
+            (and (> x 0) (<= y 0) (< x y))
+            (and (= x 0) (< y 0) (< x y))
+            (and (= y 0) (< x 0) (> x y))
+            (and (< (* x y) 0) (> x 0) (> y 0))))
+(check-sat)
+(exit)
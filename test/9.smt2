@@ -0,0 +1,13 @@
+(set-info :smt-lib-version 2.6)
+(set-logic QF_NIA)
+(set-info :source |regression: sums whose magnitude bits are known but whose sign is not|)
+(set-info :category "crafted")
+(set-info :status unsat)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (>= x (- 6)) (<= x 6) (>= y (- 6)) (<= y 6) (distinct x 0) (distinct y 0)))
+(assert (or (distinct (- (ite (> x 0) 1 (- 1))) (ite (> x 0) (- 1) 1))
+            (distinct (+ x (mod 1 x)) (ite (= (abs x) 1) x (+ x 1)))
+            (distinct (- (mod (- 1) y) y) (- (abs y) (+ y 1)))))
+(check-sat)
+(exit)
@@ -0,0 +1,37 @@
+# time of a phase of the benchmarks in test/, from the -stats report.
+# usage: ./test/bench.sh ./BLAN [./BLAN.base] [repeats]
+# with a base binary it prints both times and the speedup of the first one.
+# PHASE picks the phase (default blast, e.g. sat), NEW_OPTS and BASE_OPTS
+# are extra options of the two runs, e.g. to compare encodings of one build.
+
+NEW=${1:-./BLAN}
+BASE=$2
+REPEAT=${3:-3}
+PHASE=${PHASE:-blast}
+DIR=$(dirname "$0")
+
+# mean of the phase over the repeats
+measure(){
+    total=0
+    for r in $(seq "$REPEAT"); do
+        t=$("$1" "$2" -stats -T:60 $3 | grep -o "\"$PHASE\": {\"wall\": [0-9.e+-]*" | grep -o '[0-9.e+-]*$')
+        total=$(echo "$total ${t:-0}" | awk '{ printf "%.6f", $1 + $2 }')
+    done
+    echo "$total $REPEAT" | awk '{ printf "%.6f", $1 / $2 }'
+}
+
+if [ -z "$BASE" ]; then
+    printf "%-24s %12s\n" "benchmark" "$PHASE(s)"
+else
+    printf "%-24s %12s %12s %8s\n" "benchmark" "base(s)" "$PHASE(s)" "speedup"
+fi
+for f in "$DIR"/*.smt2; do
+    new=$(measure "$NEW" "$f" "$NEW_OPTS")
+    if [ -z "$BASE" ]; then
+        printf "%-24s %12s\n" "$(basename "$f")" "$new"
+    else
+        base=$(measure "$BASE" "$f" "$BASE_OPTS")
+        speedup=$(echo "$base $new" | awk '{ if ($2 > 0) printf "%.2f", $1 / $2; else print "-" }')
+        printf "%-24s %12s %12s %8s\n" "$(basename "$f")" "$base" "$new" "$speedup"
+    fi
+done
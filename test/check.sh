@@ -0,0 +1,20 @@
+# the answers on test/*.smt2 against their :status.
+# usage: ./test/check.sh ./BLAN
+# a line "; options: ..." of a file adds options to its run.
+
+BLAN=${1:-./BLAN}
+DIR=$(dirname "$0")
+fails=0
+
+for f in "$DIR"/*.smt2; do
+    expected=$(grep -o ':status [a-z]*' "$f" | awk '{ print $2 }')
+    opts=$(grep '^; options:' "$f" | sed 's/^; options://')
+    got=$("$BLAN" "$f" -T:60 $opts | head -n 1)
+    if [ "$got" = "$expected" ]; then
+        printf "%-24s %s\n" "$(basename "$f")" "$got"
+    else
+        printf "%-24s %s, expected %s\n" "$(basename "$f")" "$got" "$expected"
+        fails=$((fails + 1))
+    fi
+done
+exit $fails
@@ -0,0 +1,71 @@
+/* deadline.hpp
+*
+*  Copyright (C) 2023-2026 Fuqi Jia.
+*
+*  All rights reserved.
+*/
+
+#ifndef _DEADLINE_H
+#define _DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+#include <sys/resource.h>
+
+namespace ismt
+{
+    // the budget of a run: wall time, peak memory and conflicts per sat call.
+    // each phase checks it and gives up with unknown, the signal handlers
+    // only raise it.
+    class deadline
+    {
+    private:
+        std::atomic<bool>   raised;
+        std::atomic<unsigned> polls;
+        bool                timed = false;
+        std::chrono::steady_clock::time_point end;
+        long                memory = 0; // MB, 0 for no ceiling
+    public:
+        int                 conflicts = 0; // per sat call, 0 for no limit
+
+        deadline(): raised(false), polls(0){}
+        ~deadline(){}
+
+        void set_time(double seconds){
+            if(seconds <= 0) return;
+            timed = true;
+            end = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds((long long)(seconds * 1000));
+        }
+        void set_memory(long mb){ memory = mb; }
+        // async-signal-safe
+        void interrupt(){ raised.store(true, std::memory_order_relaxed); }
+
+        bool expired(){
+            if(raised.load(std::memory_order_relaxed)) return true;
+            if(timed && std::chrono::steady_clock::now() >= end){
+                interrupt();
+                return true;
+            }
+            if(memory > 0){
+                struct rusage usage;
+                // ru_maxrss in KB
+                if(getrusage(RUSAGE_SELF, &usage) == 0 && usage.ru_maxrss / 1024 >= memory){
+                    interrupt();
+                    return true;
+                }
+            }
+            return false;
+        }
+        // for hot loops, e.g. the terminator of the sat solver: the clock and
+        // the memory are read every 64 calls.
+        bool poll(){
+            if(raised.load(std::memory_order_relaxed)) return true;
+            if((polls.fetch_add(1, std::memory_order_relaxed) & 63) != 0) return false;
+            return expired();
+        }
+    };
+
+} // namespace ismt
+
+#endif
@@ -0,0 +1,213 @@
+/* statistics.hpp
+*
+*  Copyright (C) 2023-2026 Fuqi Jia.
+*
+*  All rights reserved.
+*/
+
+#ifndef _STATISTICS_H
+#define _STATISTICS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+#include <ctime>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <sys/resource.h>
+
+namespace ismt
+{
+    // the -stats report: time of the phases, the size of the sat calls and
+    // what the blaster spent on each operation and constraint.
+    // the threads add to it under its lock.
+    class statistics
+    {
+    public:
+        struct phase{
+            double wall = 0;
+            double cpu = 0;
+            unsigned long calls = 0;
+        };
+        struct round{
+            int         worker = 0;
+            int         index = 0;  // width round of the worker
+            int         vars = 0;
+            int         clauses = 0;
+            int64_t     conflicts = 0;
+            int64_t     decisions = 0;
+            int64_t     propagations = 0;
+            std::string result;
+        };
+        // sat variables and clauses of an operation, with and without the
+        // operations nested in it.
+        struct cost{
+            unsigned long calls = 0;
+            long        vars = 0;
+            long        clauses = 0;
+            long        self_vars = 0;
+            long        self_clauses = 0;
+        };
+        // the constraints with the most clauses in the report
+        static const size_t top = 20;
+    private:
+        std::mutex                      mtx;
+        std::chrono::steady_clock::time_point start;
+        std::map<std::string, phase>    phases;
+        std::vector<std::string>        order; // of the first call
+        std::vector<round>              rounds;
+        std::map<std::string, cost>     operations;
+        std::vector<std::string>        op_order;
+        std::map<const void*, cost>     constraints;
+        std::map<std::string, long>     counts;
+
+        static std::string quote(const std::string& s){
+            std::string ans;
+            for(size_t i=0;i<s.size();i++){
+                if(s[i] == '"' || s[i] == '\\'){ ans += '\\'; ans += s[i]; }
+                else if(s[i] == '\n' || s[i] == '\t') ans += ' ';
+                else ans += s[i];
+            }
+            return ans;
+        }
+    public:
+        statistics(): start(std::chrono::steady_clock::now()){}
+        ~statistics(){}
+
+        // cpu time of the calling thread
+        static double cpu(){
+            struct timespec ts;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return ts.tv_sec + ts.tv_nsec * 1e-9;
+        }
+        static double wall(){
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void add_phase(const std::string& name, double w, double c){
+            std::lock_guard<std::mutex> lock(mtx);
+            if(phases.find(name) == phases.end()) order.emplace_back(name);
+            phase& p = phases[name];
+            p.wall += w;
+            p.cpu += c;
+            ++p.calls;
+        }
+        void add_round(const round& r){
+            std::lock_guard<std::mutex> lock(mtx);
+            rounds.emplace_back(r);
+        }
+        void add_operation(const std::string& name, const cost& c){
+            if(c.calls == 0) return;
+            std::lock_guard<std::mutex> lock(mtx);
+            if(operations.find(name) == operations.end()) op_order.emplace_back(name);
+            cost& o = operations[name];
+            o.calls += c.calls;
+            o.vars += c.vars;
+            o.clauses += c.clauses;
+            o.self_vars += c.self_vars;
+            o.self_clauses += c.self_clauses;
+        }
+        void add_count(const std::string& name, long n){
+            std::lock_guard<std::mutex> lock(mtx);
+            counts[name] += n;
+        }
+        // key: the top-level constraint, named by the describe of print.
+        void add_constraint(const void* key, long vars, long clauses){
+            std::lock_guard<std::mutex> lock(mtx);
+            cost& c = constraints[key];
+            ++c.calls;
+            c.vars += vars;
+            c.clauses += clauses;
+        }
+
+        void print(std::ostream& out, const std::string& result,
+                   const std::function<std::string(const void*)>& describe = nullptr){
+            std::lock_guard<std::mutex> lock(mtx);
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double cputotal = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+                              usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+            out<<"{\"result\": \""<<result<<"\", ";
+            out<<"\"wall\": "<<total<<", ";
+            out<<"\"cpu\": "<<cputotal<<", ";
+            out<<"\"peak_rss_mb\": "<<usage.ru_maxrss / 1024.0<<", ";
+            out<<"\"rounds\": "<<rounds.size()<<",\n";
+            out<<" \"phases\": {";
+            for(size_t i=0;i<order.size();i++){
+                const phase& p = phases[order[i]];
+                out<<(i==0?"\n":",\n");
+                out<<"  \""<<order[i]<<"\": {\"wall\": "<<p.wall<<", \"cpu\": "<<p.cpu<<", \"calls\": "<<p.calls<<"}";
+            }
+            out<<"},\n";
+            out<<" \"sat_calls\": [";
+            for(size_t i=0;i<rounds.size();i++){
+                const round& r = rounds[i];
+                out<<(i==0?"\n":",\n");
+                out<<"  {\"worker\": "<<r.worker<<", \"round\": "<<r.index;
+                out<<", \"vars\": "<<r.vars<<", \"clauses\": "<<r.clauses;
+                out<<", \"conflicts\": "<<r.conflicts<<", \"decisions\": "<<r.decisions;
+                out<<", \"propagations\": "<<r.propagations<<", \"result\": \""<<r.result<<"\"}";
+            }
+            out<<"],\n";
+            out<<" \"operations\": {";
+            for(size_t i=0;i<op_order.size();i++){
+                const cost& c = operations[op_order[i]];
+                out<<(i==0?"\n":",\n");
+                out<<"  \""<<op_order[i]<<"\": {\"calls\": "<<c.calls;
+                out<<", \"vars\": "<<c.vars<<", \"clauses\": "<<c.clauses;
+                out<<", \"self_vars\": "<<c.self_vars<<", \"self_clauses\": "<<c.self_clauses<<"}";
+            }
+            out<<"},\n";
+            out<<" \"counts\": {";
+            for(auto it=counts.begin();it!=counts.end();++it){
+                out<<(it==counts.begin()?"":", ");
+                out<<"\""<<it->first<<"\": "<<it->second;
+            }
+            out<<"},\n";
+            // the most expensive constraints first
+            std::vector<std::pair<const void*, cost>> sorted(constraints.begin(), constraints.end());
+            std::sort(sorted.begin(), sorted.end(),
+                [](const std::pair<const void*, cost>& a, const std::pair<const void*, cost>& b){
+                    return a.second.clauses > b.second.clauses;
+                });
+            out<<" \"constraints\": "<<sorted.size()<<",\n";
+            out<<" \"top_constraints\": [";
+            for(size_t i=0;i<sorted.size() && i<top;i++){
+                const cost& c = sorted[i].second;
+                out<<(i==0?"\n":",\n");
+                out<<"  {";
+                if(describe) out<<"\"constraint\": \""<<quote(describe(sorted[i].first))<<"\", ";
+                out<<"\"blasts\": "<<c.calls<<", \"vars\": "<<c.vars<<", \"clauses\": "<<c.clauses<<"}";
+            }
+            out<<"]}"<<std::endl;
+        }
+    };
+
+    // times a scope into a phase, nothing without statistics.
+    class phase_timer
+    {
+    private:
+        statistics* st;
+        const char* name;
+        double      wall = 0;
+        double      cpu = 0;
+    public:
+        phase_timer(statistics* s, const char* n): st(s), name(n){
+            if(st == nullptr) return;
+            wall = statistics::wall();
+            cpu = statistics::cpu();
+        }
+        ~phase_timer(){
+            if(st == nullptr) return;
+            st->add_phase(name, statistics::wall() - wall, statistics::cpu() - cpu);
+        }
+    };
+
+} // namespace ismt
+
+#endif
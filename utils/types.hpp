@@ -54,6 +54,16 @@ namespace ismt
         poly::Integer i(v);
         return i;
     }
+    // div and mod of smt-lib, the euclidean ones: a = q * b + r, 0 <= r < |b|.
+    // Boute, Raymond T. The Euclidean definition of the functions div and mod. TOPLAS 14 (2), 1992.
+    inline Integer euclid_mod(const Integer& a, const Integer& b){
+        Integer r = a % b;
+        if(r < 0) r += abs(b);
+        return r;
+    }
+    inline Integer euclid_div(const Integer& a, const Integer& b){
+        return (a - euclid_mod(a, b)) / b;
+    }
 } // namespace ismt
 
 